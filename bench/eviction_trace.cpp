@@ -0,0 +1,91 @@
+/*
+ * eviction_trace.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+// Replay a key trace through ForgetfulHash with each eviction policy and print the hit and miss counts
+// The trace is a whitespace-separated list of unsigned integer keys, read from the file given as argument or from the standard input
+// Every key is looked up with find_and_prioritize() and inserted on a miss, as a read-through cache would do
+// Not part of the meson build; on the host:
+//   g++ -std=c++17 -O2 -I.. -o eviction_trace eviction_trace.cpp
+//   ./eviction_trace trace.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include "tx_hash.hpp"
+
+using namespace TXLib;
+
+extern "C" void tx_assert(size_t condition) {if (!condition) {abort();}}
+
+
+template <size_t VALUE_CAPACITY, template <size_t> class Eviction>
+static void replay(char const * name, std::vector<uint32_t> const & trace)
+{
+	static constexpr size_t const KEY_CAPACITY = VALUE_CAPACITY * 2;
+	typedef ForgetfulHash<uint32_t, uint32_t, KEY_CAPACITY, VALUE_CAPACITY, hash_index<uint32_t, KEY_CAPACITY>, Eviction> Cache;
+
+	Cache * cache = new Cache();
+	for (uint32_t key : trace)
+	{
+		if (cache->find_and_prioritize(key) == nullptr)
+		{
+			cache->insert(key, key);
+		}
+	}
+
+	size_t hit_count = cache->get_hit_count();
+	size_t miss_count = cache->get_miss_count();
+	printf("%8zu  %-8s  %10zu  %10zu  %6.2f%%\n", VALUE_CAPACITY, name, hit_count, miss_count,
+			100.0 * hit_count / (hit_count + miss_count));
+	delete cache;
+}
+
+template <size_t VALUE_CAPACITY>
+static void replay_all(std::vector<uint32_t> const & trace)
+{
+	replay<VALUE_CAPACITY, EvictionNearest>("Nearest", trace);
+	replay<VALUE_CAPACITY, EvictionClock>("Clock", trace);
+	replay<VALUE_CAPACITY, EvictionLRU>("LRU", trace);
+	replay<VALUE_CAPACITY, EvictionS3FIFO>("S3FIFO", trace);
+}
+
+
+int main(int argc, char ** argv)
+{
+	FILE * file = stdin;
+	if (argc > 1)
+	{
+		file = fopen(argv[1], "r");
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Cannot open %s\n", argv[1]);
+			return 1;
+		}
+	}
+
+	std::vector<uint32_t> trace;
+	unsigned long key;
+	while (fscanf(file, "%lu", &key) == 1)
+	{
+		trace.push_back((uint32_t) key);
+	}
+	if (file != stdin) {fclose(file);}
+	if (trace.empty())
+	{
+		fprintf(stderr, "Empty trace\n");
+		return 1;
+	}
+
+	printf("%zu accesses\n", trace.size());
+	printf("%8s  %-8s  %10s  %10s  %7s\n", "capacity", "policy", "hits", "misses", "ratio");
+	replay_all<64>(trace);
+	replay_all<256>(trace);
+	replay_all<1024>(trace);
+	replay_all<4096>(trace);
+	return 0;
+}
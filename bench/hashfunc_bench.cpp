@@ -0,0 +1,159 @@
+/*
+ * hashfunc_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+// Throughput and quality of the hash functions of tx_hashfunc.hpp
+// Throughput: hash_u32, hash_u64 and hash_bytes over several key sizes, in millions of hashes and in bytes per second
+// Quality: avalanche (probability that an output bit flips when one input bit flips, ideally 0.5)
+// and chi-square of the bucket counts after reduce_range(), on sequential and clustered keys (ideally close to the bucket count)
+// Not part of the meson build; on the host:
+//   g++ -std=c++17 -O2 -I.. -o hashfunc_bench hashfunc_bench.cpp
+//   ./hashfunc_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "tx_hashfunc.hpp"
+
+using namespace TXLib;
+
+extern "C" void tx_assert(size_t condition) {if (!condition) {abort();}}
+
+
+static constexpr size_t const BUCKET_COUNT = 1024;
+static constexpr size_t const KEY_COUNT = BUCKET_COUNT * 64;
+
+static volatile uint64_t g_sink;	// Keeps the hashed results alive
+
+static double get_seconds(void)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Hash>
+static double measure(size_t count, Hash hash)
+// Return the number of hashes per second
+{
+	uint64_t sum = 0;
+	double begin = get_seconds();
+	for (size_t i = 0; i < count; i++)
+	{
+		sum += hash(i);
+	}
+	double elapsed = get_seconds() - begin;
+	g_sink = sum;
+	return count / elapsed;
+}
+
+static void bench_throughput(void)
+{
+	static constexpr size_t const COUNT = 20000000;
+	printf("Throughput\n");
+	printf("  %-18s %10.1f Mhash/s\n", "hash_u32", measure(COUNT, [](size_t i) {return (uint64_t) hash_u32((uint32_t) i);}) / 1e6);
+	printf("  %-18s %10.1f Mhash/s\n", "hash_u64", measure(COUNT, [](size_t i) {return hash_u64(i);}) / 1e6);
+
+	static size_t const SIZE_LIST[] = {4, 8, 16, 32, 64, 256, 1024, 4096};
+	static uint8_t buffer[4096 + 64];
+	for (size_t i = 0; i < sizeof(buffer); i++)
+	{
+		buffer[i] = (uint8_t)(i * 131 + 7);
+	}
+	for (size_t size : SIZE_LIST)
+	{
+		size_t count = COUNT * 8 / (size + 32);
+		double rate = measure(count, [size](size_t i) {return hash_bytes(buffer + (i & 63), size);});
+		char name[32];
+		snprintf(name, sizeof(name), "hash_bytes(%zu)", size);
+		printf("  %-18s %10.1f Mhash/s %10.1f MB/s\n", name, rate / 1e6, rate * size / 1e6);
+	}
+}
+
+template <typename Hash>
+static void print_avalanche(char const * name, size_t input_bits, size_t output_bits, Hash hash)
+// Flip each input bit of random keys; report the flip probability of the output bits that deviates most from 0.5
+{
+	static constexpr size_t const TRIAL_COUNT = 20000;
+	std::vector<uint32_t> flip_list(input_bits * output_bits, 0);
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+	for (size_t t = 0; t < TRIAL_COUNT; t++)
+	{
+		state = hash_u64(state);
+		uint64_t key = (input_bits == 64) ? state : (state & ((1ull << input_bits) - 1));
+		uint64_t base = hash(key);
+		for (size_t i = 0; i < input_bits; i++)
+		{
+			uint64_t diff = base ^ hash(key ^ (1ull << i));
+			for (size_t o = 0; o < output_bits; o++)
+			{
+				flip_list[i * output_bits + o] += (diff >> o) & 1;
+			}
+		}
+	}
+	double worst = 0.0;
+	double total = 0.0;
+	for (uint32_t flip : flip_list)
+	{
+		double bias = fabs((double) flip / TRIAL_COUNT - 0.5);
+		if (bias > worst) {worst = bias;}
+		total += bias;
+	}
+	printf("  %-18s mean bias %.4f, worst bias %.4f\n", name, total / flip_list.size(), worst);
+}
+
+template <typename Hash>
+static double compute_chi_square(Hash hash, uint64_t (*make_key)(size_t))
+// Chi-square of KEY_COUNT keys over BUCKET_COUNT buckets; its expected value is about BUCKET_COUNT - 1
+{
+	std::vector<uint32_t> bucket_list(BUCKET_COUNT, 0);
+	for (size_t i = 0; i < KEY_COUNT; i++)
+	{
+		bucket_list[reduce_range(hash(make_key(i)), BUCKET_COUNT)]++;
+	}
+	double expected = (double) KEY_COUNT / BUCKET_COUNT;
+	double chi_square = 0.0;
+	for (uint32_t count : bucket_list)
+	{
+		chi_square += (count - expected) * (count - expected) / expected;
+	}
+	return chi_square;
+}
+
+static uint64_t make_sequential_key(size_t i) {return i;}
+static uint64_t make_clustered_key(size_t i) {return (uint64_t)(i / 16) << 20 | (i % 16);}	// Small clusters far apart, as in pointers or IDs with a type tag
+static uint64_t make_aligned_key(size_t i) {return (uint64_t) i << 12;}										// Low bits always zero, as in page addresses
+
+template <typename Hash>
+static void print_chi_square(char const * name, Hash hash)
+{
+	printf("  %-18s sequential %8.1f  clustered %8.1f  aligned %8.1f\n", name,
+			compute_chi_square(hash, make_sequential_key), compute_chi_square(hash, make_clustered_key), compute_chi_square(hash, make_aligned_key));
+}
+
+static void bench_quality(void)
+{
+	printf("Avalanche (bias of the output bit flip probability from 0.5)\n");
+	print_avalanche("hash_u32", 32, 32, [](uint64_t key) {return (uint64_t) hash_u32((uint32_t) key);});
+	print_avalanche("hash_u64", 64, 64, [](uint64_t key) {return hash_u64(key);});
+	print_avalanche("hash_bytes(8)", 64, 64, [](uint64_t key) {return hash_bytes(&key, sizeof(key));});
+
+	printf("Chi-square over %zu buckets with reduce_range (expected about %zu)\n", BUCKET_COUNT, BUCKET_COUNT - 1);
+	print_chi_square("identity", [](uint64_t key) {return (uint32_t) key;});
+	print_chi_square("hash_u32", [](uint64_t key) {return hash_u32((uint32_t) key);});
+	print_chi_square("hash_u64", [](uint64_t key) {uint64_t hash = hash_u64(key); return (uint32_t)(hash ^ (hash >> 32));});
+	print_chi_square("hash_bytes(8)", [](uint64_t key) {uint64_t hash = hash_bytes(&key, sizeof(key)); return (uint32_t)(hash ^ (hash >> 32));});
+}
+
+
+int main(void)
+{
+	bench_throughput();
+	bench_quality();
+	return 0;
+}
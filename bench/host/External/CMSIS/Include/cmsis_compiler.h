@@ -0,0 +1,18 @@
+/*
+ * cmsis_compiler.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+// Host stand-in for the CMSIS header included by tx_spinlock.hpp, so that the benchmarks build on a PC (with -Ihost)
+// There is no interrupt to mask: PRIMASK is only emulated for each thread
+
+#pragma once
+
+#include <stdint.h>
+
+static thread_local uint32_t g_host_primask;
+
+static inline uint32_t __get_PRIMASK(void) {return g_host_primask;}
+static inline void __set_PRIMASK(uint32_t primask) {g_host_primask = primask;}
@@ -0,0 +1,159 @@
+/*
+ * skiplist_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+// Throughput of ConcurrentSkipList against ordered maps behind one global lock (BTreeMap and std::map with std::mutex)
+// Every thread runs the same number of operations on random keys, half of which are present:
+// a read-only mix (lookups) and a mixed one (90% lookups, 5% insertions, 5% removals), with 1 to 16 threads
+// Not part of the meson build; on the host (host/ provides the CMSIS header of tx_spinlock.hpp):
+//   g++ -std=c++17 -O2 -pthread -I.. -Ihost -o skiplist_bench skiplist_bench.cpp
+//   ./skiplist_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tx_skiplist.hpp"
+#include "tx_btree.hpp"
+
+using namespace TXLib;
+
+extern "C" void tx_assert(size_t condition) {if (!condition) {abort();}}
+
+
+static constexpr uint32_t const KEY_RANGE = 1u << 18;
+static constexpr size_t const OPERATION_COUNT = 400000;	// Per thread
+static size_t const THREAD_COUNT_LIST[] = {1, 2, 4, 8, 16};
+
+// Each structure is driven through find(), insert() and remove() of uint32_t keys
+struct SkipListMap
+{
+	ConcurrentSkipList<uint32_t, uint32_t>		list;
+
+	SkipListMap(void) : list(malloc, free, 10) {}
+	bool find(uint32_t key, uint32_t & value) {return list.find(key, value);}
+	void insert(uint32_t key, uint32_t value) {list.insert(key, value);}
+	void remove(uint32_t key) {list.remove(key);}
+};
+
+struct LockedBTreeMap
+{
+	BTreeMap<uint32_t, uint32_t>		tree;
+	std::mutex											mutex;
+
+	LockedBTreeMap(void) {tree.initialize(malloc, free, 6);}
+
+	bool find(uint32_t key, uint32_t & value)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		uint32_t * found = tree.find(key);
+		if (found == nullptr) {return false;}
+		value = *found;
+		return true;
+	}
+
+	void insert(uint32_t key, uint32_t value) {std::lock_guard<std::mutex> lock(mutex); tree.insert(key, value);}
+	void remove(uint32_t key) {std::lock_guard<std::mutex> lock(mutex); tree.remove(key);}
+};
+
+struct LockedStdMap
+{
+	std::map<uint32_t, uint32_t>		map;
+	std::mutex											mutex;
+
+	bool find(uint32_t key, uint32_t & value)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto found = map.find(key);
+		if (found == map.end()) {return false;}
+		value = found->second;
+		return true;
+	}
+
+	void insert(uint32_t key, uint32_t value) {std::lock_guard<std::mutex> lock(mutex); map[key] = value;}
+	void remove(uint32_t key) {std::lock_guard<std::mutex> lock(mutex); map.erase(key);}
+};
+
+
+template <typename Map>
+static double measure(size_t thread_count, size_t write_percent)
+// Return millions of operations per second over all threads
+{
+	Map * map = new Map();
+	for (uint32_t key = 0; key < KEY_RANGE; key += 2)
+	{
+		map->insert(key, key);
+	}
+
+	std::atomic<size_t> ready_count(0);
+	std::atomic<bool> is_started(false);
+	std::atomic<uint64_t> checksum(0);
+	std::vector<std::thread> thread_list;
+	for (size_t t = 0; t < thread_count; t++)
+	{
+		thread_list.emplace_back([&, t]
+		{
+			uint32_t random = hash_u32((uint32_t) t + 1);
+			uint64_t sum = 0;
+			ready_count.fetch_add(1);
+			while (!is_started.load(std::memory_order_acquire)) {std::this_thread::yield();}
+			for (size_t i = 0; i < OPERATION_COUNT; i++)
+			{
+				// xorshift32
+				random ^= random << 13;
+				random ^= random >> 17;
+				random ^= random << 5;
+				uint32_t key = random % KEY_RANGE;
+				uint32_t operation = (random >> 24) % 100;
+				uint32_t value;
+				if (operation >= write_percent) {sum += map->find(key, value) ? value : 0;}
+				else if (operation % 2 == 0) {map->insert(key, key);}
+				else {map->remove(key);}
+			}
+			checksum.fetch_add(sum, std::memory_order_relaxed);
+		});
+	}
+
+	while (ready_count.load() < thread_count) {std::this_thread::yield();}
+	auto begin = std::chrono::steady_clock::now();
+	is_started.store(true, std::memory_order_release);
+	for (std::thread & thread : thread_list)
+	{
+		thread.join();
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	delete map;
+	return thread_count * OPERATION_COUNT / elapsed / 1e6;
+}
+
+static void run_mix(size_t write_percent)
+{
+	printf("%zu%% writes (Mops/s)\n", write_percent);
+	printf("  %7s  %12s  %12s  %12s\n", "threads", "skip list", "locked btree", "locked map");
+	for (size_t thread_count : THREAD_COUNT_LIST)
+	{
+		double skip_list = measure<SkipListMap>(thread_count, write_percent);
+		double btree = measure<LockedBTreeMap>(thread_count, write_percent);
+		double std_map = measure<LockedStdMap>(thread_count, write_percent);
+		printf("  %7zu  %12.2f  %12.2f  %12.2f\n", thread_count, skip_list, btree, std_map);
+	}
+}
+
+
+int main(void)
+{
+	printf("%u keys, %u present, %zu operations per thread, %u hardware threads\n",
+			KEY_RANGE, KEY_RANGE / 2, OPERATION_COUNT, std::thread::hardware_concurrency());
+	run_mix(0);
+	run_mix(10);
+	return 0;
+}
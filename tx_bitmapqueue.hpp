@@ -0,0 +1,171 @@
+/*
+ * tx_bitmapqueue.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tx_assert.h"
+#include "tx_linkedlist.hpp"
+
+namespace TXLib
+{
+
+// Intrusive priority queue for a small range of integer priorities [0, PRIORITY_COUNT)
+// Links with equal priority are kept in a FIFO cycle; the highest priority is served first
+// A hierarchical bitmap of the non-empty priorities is maintained so that every operation is constant-time and comparison-free
+template <size_t PRIORITY_COUNT>
+class BitmapPriorityQueue
+{
+private:
+
+	static constexpr size_t const WORD_SIZE_LOG2 = 5;
+	static constexpr size_t const WORD_SIZE = 1u << WORD_SIZE_LOG2;
+
+	static constexpr size_t word_count(size_t bit_count) {return (bit_count + WORD_SIZE - 1) >> WORD_SIZE_LOG2;}
+
+	// Level 0 has one bit per priority; a bit of level l+1 is set iff the corresponding word of level l is non-zero
+	static constexpr size_t const LEVEL0_SIZE = word_count(PRIORITY_COUNT);
+	static constexpr size_t const LEVEL1_SIZE = (LEVEL0_SIZE > 1) ? word_count(LEVEL0_SIZE) : 0;
+	static constexpr size_t const LEVEL2_SIZE = (LEVEL1_SIZE > 1) ? word_count(LEVEL1_SIZE) : 0;
+	static constexpr size_t const LEVEL_COUNT = (LEVEL2_SIZE > 0) ? 3 : (LEVEL1_SIZE > 0) ? 2 : 1;
+	static_assert(PRIORITY_COUNT > 0 && LEVEL2_SIZE <= 1, "PRIORITY_COUNT cannot exceed 2^15");
+
+	static constexpr size_t const LEVEL_OFFSET[3] = {0, LEVEL0_SIZE, LEVEL0_SIZE + LEVEL1_SIZE};
+
+private:
+
+	uint32_t					m_bitmap[LEVEL0_SIZE + LEVEL1_SIZE + LEVEL2_SIZE];
+	LinkedCycle				m_anchor[PRIORITY_COUNT];
+	size_t						m_size;
+
+private:
+
+	static size_t highest_bit(uint32_t word) {return WORD_SIZE - 1 - __builtin_clz(word);}
+
+	void set_bit(size_t priority)
+	{
+		for (size_t level = 0; level < LEVEL_COUNT; level++)
+		{
+			uint32_t & word = m_bitmap[LEVEL_OFFSET[level] + (priority >> WORD_SIZE_LOG2)];
+			bool was_empty = (word == 0);
+			word |= (uint32_t) 1u << (priority & (WORD_SIZE - 1));
+			if (!was_empty) {return;}
+			priority = priority >> WORD_SIZE_LOG2;
+		}
+	}
+
+	void clear_bit(size_t priority)
+	{
+		for (size_t level = 0; level < LEVEL_COUNT; level++)
+		{
+			uint32_t & word = m_bitmap[LEVEL_OFFSET[level] + (priority >> WORD_SIZE_LOG2)];
+			word &= ~((uint32_t) 1u << (priority & (WORD_SIZE - 1)));
+			if (word != 0) {return;}
+			priority = priority >> WORD_SIZE_LOG2;
+		}
+	}
+
+public:
+
+	BitmapPriorityQueue(void) noexcept : m_size(0)
+	{
+		for (size_t i = 0; i < sizeof(m_bitmap) / sizeof(m_bitmap[0]); i++)
+		{
+			m_bitmap[i] = 0;
+		}
+	}
+	~BitmapPriorityQueue(void) noexcept = default;
+	BitmapPriorityQueue(BitmapPriorityQueue<PRIORITY_COUNT> const &) = delete;
+	BitmapPriorityQueue(BitmapPriorityQueue<PRIORITY_COUNT> &&) = delete;
+	void operator=(BitmapPriorityQueue<PRIORITY_COUNT> const &) = delete;
+	void operator=(BitmapPriorityQueue<PRIORITY_COUNT> &&) = delete;
+
+	size_t get_size(void) const {return m_size;}
+	bool is_empty(void) const {return m_size == 0;}
+	bool is_empty(size_t priority) const {TX_ASSERT(priority < PRIORITY_COUNT); return m_anchor[priority].is_single();}
+
+	size_t get_top_priority(void) const
+	{
+		TX_ASSERT(m_size > 0);
+		size_t index = 0;
+		for (size_t level = LEVEL_COUNT; level > 0; level--)
+		{
+			index = (index << WORD_SIZE_LOG2) + highest_bit(m_bitmap[LEVEL_OFFSET[level - 1] + index]);
+		}
+		return index;
+	}
+
+	// First link of the highest non-empty priority
+	LinkedCycle & get_top(void) {return m_anchor[get_top_priority()].next();}
+	LinkedCycle const & get_top(void) const {return m_anchor[get_top_priority()].next();}
+
+	// First link of the given priority
+	LinkedCycle & get_front(size_t priority)
+	{
+		TX_ASSERT(!is_empty(priority));
+		return m_anchor[priority].next();
+	}
+
+	LinkedCycle & pop_top(void)
+	{
+		size_t priority = get_top_priority();
+		LinkedCycle & link = m_anchor[priority].next();
+		remove(link, priority);
+		return link;
+	}
+
+	// Append @link to the back of the FIFO of @priority
+	// @link must be single
+	void insert(LinkedCycle & link, size_t priority)
+	{
+		TX_ASSERT(priority < PRIORITY_COUNT);
+		if (m_anchor[priority].is_single()) {set_bit(priority);}
+		link.insert_single_as_prev_of(m_anchor[priority]);
+		m_size++;
+	}
+
+	// Remove @link, which must have been inserted with @priority
+	void remove(LinkedCycle & link, size_t priority)
+	{
+		TX_ASSERT(priority < PRIORITY_COUNT);
+		TX_ASSERT(!link.is_single());
+		link.remove_from_cycle();
+		if (m_anchor[priority].is_single()) {clear_bit(priority);}
+		m_size--;
+	}
+
+	// Move the first link of @priority to the back of its FIFO (round-robin among equal priorities)
+	void rotate(size_t priority)
+	{
+		TX_ASSERT(!is_empty(priority));
+		LinkedCycle & link = m_anchor[priority].next();
+		link.remove_from_cycle();
+		link.insert_single_as_prev_of(m_anchor[priority]);
+	}
+
+	void clear(void)
+	{
+		for (size_t i = 0; i < PRIORITY_COUNT; i++)
+		{
+			while (!m_anchor[i].is_single())
+			{
+				m_anchor[i].next().remove_from_cycle();
+			}
+		}
+		for (size_t i = 0; i < sizeof(m_bitmap) / sizeof(m_bitmap[0]); i++)
+		{
+			m_bitmap[i] = 0;
+		}
+		m_size = 0;
+	}
+
+};
+
+
+
+}
@@ -0,0 +1,169 @@
+/*
+ * tx_blobcache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+#include "tx_assert.h"
+#include "tx_hash.hpp"
+#include "tx_memory_halffit.hpp"
+
+namespace TXLib
+{
+
+// Cache of variable-size byte strings (blobs), limited by the total number of bytes
+// Blobs are copied into a dedicated AllocatorHalfFit pool; lookups return views of the pooled bytes without copying
+// Entries are evicted until the new blob fits both the byte budget and the pool, so that a large blob displaces several small ones
+// Eviction is size-aware: to free bytes, the largest of the next VICTIM_CANDIDATE_COUNT entries in the order of the @Eviction policy is evicted
+// (the others keep their place), so that fewer entries are lost per byte freed, as in GDSF with a uniform miss cost
+// The pool should be somewhat larger than the budget to absorb fragmentation; eviction also makes room when the pool is fragmented
+template <typename Key, size_t KEY_CAPACITY, size_t ENTRY_CAPACITY, size_t hash_func(Key), template <size_t> class Eviction = EvictionLRU>
+class BlobCache
+{
+public:
+
+	// Valid until the next insertion, removal or clearing
+	struct View
+	{
+		void const *		data;
+		size_t					size;
+	};
+
+private:
+
+	static constexpr size_t const VICTIM_CANDIDATE_COUNT = 4;
+
+	struct Blob
+	{
+		void *					data;
+		size_t					size;
+	};
+
+private:
+
+	ForgetfulHash<Key, Blob, KEY_CAPACITY, ENTRY_CAPACITY, hash_func, Eviction>		m_table;
+	AllocatorHalfFit		m_pool;
+	size_t							m_byte_budget;
+	size_t							m_byte_count;		// Bytes of the blobs in the cache
+
+private:
+
+	bool evict_one(size_t candidate_count)
+	// Evict the largest of the next @candidate_count entries
+	{
+		Blob blob;
+		if (!m_table.evict(blob, candidate_count, [](Blob const & a, Blob const & b) {return a.size > b.size;})) {return false;}
+		m_byte_count -= blob.size;
+		m_pool.free(blob.data);
+		return true;
+	}
+
+public:
+
+	BlobCache(void) : m_byte_budget(0), m_byte_count(0) {}
+	BlobCache(void * pool, size_t pool_size, size_t byte_budget) : m_byte_count(0) {initialize(pool, pool_size, byte_budget);}
+	~BlobCache(void) {uninitialize();}
+	BlobCache(BlobCache const &) = delete;
+	BlobCache(BlobCache &&) = delete;
+	void operator=(BlobCache const &) = delete;
+	void operator=(BlobCache &&) = delete;
+
+	bool is_initialized(void) const {return m_pool.is_initialized();}
+
+	// @pool is the memory in which the blobs are stored
+	void initialize(void * pool, size_t pool_size, size_t byte_budget)
+	{
+		TX_ASSERT(!is_initialized());
+		m_pool.initialize(pool, pool_size);
+		m_byte_budget = byte_budget;
+		m_byte_count = 0;
+	}
+
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+		clear();
+		m_pool.uninitialize();
+	}
+
+	size_t get_size(void) const {return m_table.get_size();}
+	size_t get_byte_count(void) const {return m_byte_count;}
+	size_t get_byte_budget(void) const {return m_byte_budget;}
+
+	// Statistics of find()
+	size_t get_hit_count(void) const {return m_table.get_hit_count();}
+	size_t get_miss_count(void) const {return m_table.get_miss_count();}
+	void reset_statistics(void) {m_table.reset_statistics();}
+
+	// Lowering the budget evicts entries immediately
+	void set_byte_budget(size_t byte_budget)
+	{
+		m_byte_budget = byte_budget;
+		while (m_byte_count > m_byte_budget && evict_one(VICTIM_CANDIDATE_COUNT));
+	}
+
+	bool find(Key const & key, View & view)
+	{
+		Blob const * blob = m_table.find(key);
+		if (blob == nullptr) {return false;}
+		view.data = blob->data;
+		view.size = blob->size;
+		return true;
+	}
+
+	// Copy @size bytes at @data into the cache, replacing the current blob of the key
+	// Return false if the blob cannot fit even in an empty cache; the key is then absent
+	bool insert(Key const & key, void const * data, size_t size)
+	{
+		TX_ASSERT(is_initialized());
+
+		remove(key);
+		if (size > m_byte_budget) {return false;}
+
+		while (m_byte_count + size > m_byte_budget)
+		{
+			evict_one(VICTIM_CANDIDATE_COUNT);
+		}
+		if (m_table.get_size() >= ENTRY_CAPACITY)
+		{
+			evict_one(1);
+		}
+
+		void * pooled = m_pool.try_alloc(size);
+		while (pooled == nullptr)
+		{
+			if (!evict_one(VICTIM_CANDIDATE_COUNT)) {return false;}
+			pooled = m_pool.try_alloc(size);
+		}
+
+		memcpy(pooled, data, size);
+		m_table.insert(key, Blob{pooled, size});
+		m_byte_count += size;
+		return true;
+	}
+
+	// Remove the key if it exists
+	void remove(Key const & key)
+	{
+		Blob blob;
+		if (!m_table.remove(key, blob)) {return;}
+		m_byte_count -= blob.size;
+		m_pool.free(blob.data);
+	}
+
+	void clear(void)
+	{
+		while (evict_one(1));
+		m_table.clear();
+	}
+
+};
+
+
+
+}
@@ -0,0 +1,657 @@
+/*
+ * tx_btree.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include "tx_assert.h"
+
+namespace TXLib
+{
+
+// Ordered map as a B+ tree
+// Every node takes NODE_SIZE bytes, a multiple of the cache line, and holds as many keys as fit; keys are ordered by operator<
+// Entries are only stored in the leaves, which are linked in key order, so that range scans walk the leaves sequentially
+// Nodes split evenly, except when a key is appended at the end of the tree: the left node then stays full, so that sorted insertion packs the nodes
+// Searching in a node counts the smaller keys without branching for arithmetic keys (vectorized where SIMD is available), binary search otherwise
+// Nodes are carved from slabs of 2^(slab_size_log2) nodes allocated through @Alloc and recycled through a free list
+// Key and Value must be trivially copyable; iterators are invalidated by insertion and removal
+template <typename Key, typename Value, size_t NODE_SIZE = 256>
+class BTreeMap
+{
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+private:
+
+	static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value);
+
+	struct Node
+	{
+		uint16_t			count;		// Number of keys
+		uint16_t			is_leaf;
+	};
+
+	static constexpr size_t const LEAF_CAPACITY = (NODE_SIZE - 2 * sizeof(void *)) / (sizeof(Key) + sizeof(Value));
+	static constexpr size_t const INNER_CAPACITY = (NODE_SIZE - 2 * sizeof(void *)) / (sizeof(Key) + sizeof(void *));
+	static constexpr size_t const LEAF_MIN = LEAF_CAPACITY / 2;
+	static constexpr size_t const INNER_MIN = INNER_CAPACITY / 2;
+	static constexpr size_t const HEIGHT_MAX = 32;
+
+	struct Leaf : Node
+	{
+		Leaf *				next;
+		Key						key_list[LEAF_CAPACITY];
+		Value					value_list[LEAF_CAPACITY];
+	};
+
+	// Child i holds the keys in [key_list[i - 1], key_list[i])
+	struct Inner : Node
+	{
+		Key						key_list[INNER_CAPACITY];
+		Node *				child_list[INNER_CAPACITY + 1];
+	};
+
+	static_assert(LEAF_CAPACITY >= 4 && INNER_CAPACITY >= 4, "NODE_SIZE is too small for the key and value");
+	static_assert(sizeof(Leaf) <= NODE_SIZE && sizeof(Inner) <= NODE_SIZE);
+	static_assert(LEAF_CAPACITY < 0x10000 && INNER_CAPACITY < 0x10000);
+
+	union NodeStorage
+	{
+		NodeStorage *		next_free;
+		alignas(Leaf) alignas(Inner) uint8_t		bytes[NODE_SIZE];
+	};
+
+	struct Slab
+	{
+		Slab *				next;
+	};
+
+	static constexpr size_t const SLAB_HEADER_SIZE = ((sizeof(Slab) + alignof(NodeStorage) - 1) / alignof(NodeStorage)) * alignof(NodeStorage);
+
+public:
+
+	// Position of an entry in a leaf
+	class Iterator
+	{
+		friend BTreeMap<Key, Value, NODE_SIZE>;
+
+	private:
+		Leaf *				m_leaf;		// nullptr at the end
+		size_t				m_index;
+
+	private:
+		Iterator(Leaf * leaf, size_t index) noexcept : m_leaf(leaf), m_index(index)
+		{
+			// Leaves other than an empty root are never empty
+			if (m_leaf != nullptr && m_index == m_leaf->count) {m_leaf = m_leaf->next; m_index = 0;}
+		}
+
+	public:
+		Iterator(void) noexcept : m_leaf(nullptr), m_index(0) {}
+
+		Key const & get_key(void) const {return m_leaf->key_list[m_index];}
+		Value & get_value(void) const {return m_leaf->value_list[m_index];}
+
+		Iterator & operator++(void)
+		{
+			m_index++;
+			if (m_index == m_leaf->count) {m_leaf = m_leaf->next; m_index = 0;}
+			return *this;
+		}
+
+		bool operator==(Iterator const & b) const {return m_leaf == b.m_leaf && m_index == b.m_index;}
+		bool operator!=(Iterator const & b) const {return !(*this == b);}
+	};
+
+private:
+
+	Node *				m_root;
+	Leaf *				m_first_leaf;
+	size_t				m_size;
+	size_t				m_height;			// Number of inner levels above the leaves
+
+	NodeStorage *	m_free_head;
+	Slab *				m_slab_head;
+	size_t				m_slab_size_log2;
+
+	Alloc					m_alloc;
+	Free					m_free;
+
+private:
+
+	static bool is_equal(Key const & a, Key const & b) {return !(a < b) && !(b < a);}
+
+	// Number of keys smaller than @key
+	static size_t lower_bound(Key const * key_list, size_t count, Key const & key)
+	{
+		if constexpr (std::is_arithmetic<Key>::value)
+		{
+			size_t position = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				position += (key_list[i] < key);
+			}
+			return position;
+		}
+		else
+		{
+			size_t low = 0, high = count;
+			while (low < high)
+			{
+				size_t middle = (low + high) / 2;
+				if (key_list[middle] < key) {low = middle + 1;}
+				else {high = middle;}
+			}
+			return low;
+		}
+	}
+
+	// Number of keys smaller or equal to @key
+	static size_t upper_bound(Key const * key_list, size_t count, Key const & key)
+	{
+		if constexpr (std::is_arithmetic<Key>::value)
+		{
+			size_t position = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				position += !(key < key_list[i]);
+			}
+			return position;
+		}
+		else
+		{
+			size_t low = 0, high = count;
+			while (low < high)
+			{
+				size_t middle = (low + high) / 2;
+				if (!(key < key_list[middle])) {low = middle + 1;}
+				else {high = middle;}
+			}
+			return low;
+		}
+	}
+
+	void * acquire_node(void)
+	{
+		if (m_free_head == nullptr)
+		{
+			Slab * slab = (Slab *) m_alloc(SLAB_HEADER_SIZE + (1u << m_slab_size_log2) * sizeof(NodeStorage));
+			TX_ASSERT(slab != nullptr);
+			slab->next = m_slab_head;
+			m_slab_head = slab;
+
+			NodeStorage * nodes = (NodeStorage *)((size_t) slab + SLAB_HEADER_SIZE);
+			for (size_t i = 0; i < (1u << m_slab_size_log2); i++)
+			{
+				release_node(nodes + i);
+			}
+		}
+		NodeStorage * storage = m_free_head;
+		m_free_head = storage->next_free;
+		return storage;
+	}
+
+	void release_node(void * node)
+	{
+		NodeStorage * storage = (NodeStorage *) node;
+		storage->next_free = m_free_head;
+		m_free_head = storage;
+	}
+
+	Leaf * create_leaf(void)
+	{
+		Leaf * leaf = ::new(acquire_node()) Leaf;
+		leaf->count = 0;
+		leaf->is_leaf = 1;
+		leaf->next = nullptr;
+		return leaf;
+	}
+
+	Inner * create_inner(void)
+	{
+		Inner * inner = ::new(acquire_node()) Inner;
+		inner->count = 0;
+		inner->is_leaf = 0;
+		return inner;
+	}
+
+	Leaf * find_leaf(Key const & key) const
+	{
+		Node * node = m_root;
+		while (!node->is_leaf)
+		{
+			Inner * inner = static_cast<Inner *>(node);
+			node = inner->child_list[upper_bound(inner->key_list, inner->count, key)];
+		}
+		return static_cast<Leaf *>(node);
+	}
+
+	static void leaf_insert_at(Leaf * leaf, size_t position, Key const & key, Value const & value)
+	{
+		size_t count_after = leaf->count - position;
+		memmove(leaf->key_list + position + 1, leaf->key_list + position, count_after * sizeof(Key));
+		memmove(leaf->value_list + position + 1, leaf->value_list + position, count_after * sizeof(Value));
+		leaf->key_list[position] = key;
+		leaf->value_list[position] = value;
+		leaf->count++;
+	}
+
+	static void leaf_remove_at(Leaf * leaf, size_t position)
+	{
+		size_t count_after = leaf->count - position - 1;
+		memmove(leaf->key_list + position, leaf->key_list + position + 1, count_after * sizeof(Key));
+		memmove(leaf->value_list + position, leaf->value_list + position + 1, count_after * sizeof(Value));
+		leaf->count--;
+	}
+
+	// Insert @key before key @position and @child after it
+	static void inner_insert_at(Inner * inner, size_t position, Key const & key, Node * child)
+	{
+		size_t count_after = inner->count - position;
+		memmove(inner->key_list + position + 1, inner->key_list + position, count_after * sizeof(Key));
+		memmove(inner->child_list + position + 2, inner->child_list + position + 1, count_after * sizeof(Node *));
+		inner->key_list[position] = key;
+		inner->child_list[position + 1] = child;
+		inner->count++;
+	}
+
+	// Remove key @position and the child after it
+	static void inner_remove_at(Inner * inner, size_t position)
+	{
+		size_t count_after = inner->count - position - 1;
+		memmove(inner->key_list + position, inner->key_list + position + 1, count_after * sizeof(Key));
+		memmove(inner->child_list + position + 1, inner->child_list + position + 2, count_after * sizeof(Node *));
+		inner->count--;
+	}
+
+	// Return true if the key was new
+	// If @node splits, the new right sibling is returned in @split_node and its smallest key in @split_key
+	bool insert_into(Node * node, Key const & key, Value const & value, Key & split_key, Node *& split_node)
+	{
+		split_node = nullptr;
+
+		if (node->is_leaf)
+		{
+			Leaf * leaf = static_cast<Leaf *>(node);
+			size_t position = lower_bound(leaf->key_list, leaf->count, key);
+			if (position < leaf->count && is_equal(leaf->key_list[position], key))
+			{
+				leaf->value_list[position] = value;
+				return false;
+			}
+			if (leaf->count < LEAF_CAPACITY)
+			{
+				leaf_insert_at(leaf, position, key, value);
+				return true;
+			}
+
+			// Split evenly, except when appending to the last leaf: sorted insertions then leave full leaves behind
+			size_t count_left = (position == LEAF_CAPACITY && leaf->next == nullptr) ? LEAF_CAPACITY : (LEAF_CAPACITY + 1) / 2;
+			Leaf * right = create_leaf();
+			right->count = (uint16_t)(LEAF_CAPACITY - count_left);
+			memcpy(right->key_list, leaf->key_list + count_left, right->count * sizeof(Key));
+			memcpy(right->value_list, leaf->value_list + count_left, right->count * sizeof(Value));
+			leaf->count = (uint16_t) count_left;
+			right->next = leaf->next;
+			leaf->next = right;
+
+			if (position <= count_left && position < LEAF_CAPACITY) {leaf_insert_at(leaf, position, key, value);}
+			else {leaf_insert_at(right, position - count_left, key, value);}
+
+			split_key = right->key_list[0];
+			split_node = right;
+			return true;
+		}
+
+		Inner * inner = static_cast<Inner *>(node);
+		size_t position = upper_bound(inner->key_list, inner->count, key);
+		Key child_split_key;
+		Node * child_split_node;
+		bool is_new = insert_into(inner->child_list[position], key, value, child_split_key, child_split_node);
+		if (child_split_node == nullptr) {return is_new;}
+
+		if (inner->count < INNER_CAPACITY)
+		{
+			inner_insert_at(inner, position, child_split_key, child_split_node);
+			return is_new;
+		}
+
+		// Split: the middle key moves up
+		size_t count_left = (position == INNER_CAPACITY) ? INNER_CAPACITY - 1 : INNER_CAPACITY / 2;
+		Inner * right = create_inner();
+		right->count = (uint16_t)(INNER_CAPACITY - count_left - 1);
+		memcpy(right->key_list, inner->key_list + count_left + 1, right->count * sizeof(Key));
+		memcpy(right->child_list, inner->child_list + count_left + 1, (right->count + 1) * sizeof(Node *));
+		split_key = inner->key_list[count_left];
+		inner->count = (uint16_t) count_left;
+
+		if (position <= count_left) {inner_insert_at(inner, position, child_split_key, child_split_node);}
+		else {inner_insert_at(right, position - count_left - 1, child_split_key, child_split_node);}
+
+		split_node = right;
+		return is_new;
+	}
+
+	static bool is_underfull(Node const * node)
+	{
+		return node->count < (node->is_leaf ? LEAF_MIN : INNER_MIN);
+	}
+
+	// Refill child @position of @inner, which is underfull, from a sibling or by merging with a sibling
+	void fix_child(Inner * inner, size_t position)
+	{
+		Node * child = inner->child_list[position];
+		Node * left = (position > 0) ? inner->child_list[position - 1] : nullptr;
+		Node * right = (position < inner->count) ? inner->child_list[position + 1] : nullptr;
+
+		if (child->is_leaf)
+		{
+			Leaf * leaf = static_cast<Leaf *>(child);
+			if (left != nullptr && left->count > LEAF_MIN)
+			{
+				Leaf * source = static_cast<Leaf *>(left);
+				leaf_insert_at(leaf, 0, source->key_list[source->count - 1], source->value_list[source->count - 1]);
+				source->count--;
+				inner->key_list[position - 1] = leaf->key_list[0];
+			}
+			else if (right != nullptr && right->count > LEAF_MIN)
+			{
+				Leaf * source = static_cast<Leaf *>(right);
+				leaf_insert_at(leaf, leaf->count, source->key_list[0], source->value_list[0]);
+				leaf_remove_at(source, 0);
+				inner->key_list[position] = source->key_list[0];
+			}
+			else
+			{
+				size_t position_left = (left != nullptr) ? position - 1 : position;
+				Leaf * target = static_cast<Leaf *>(inner->child_list[position_left]);
+				Leaf * source = static_cast<Leaf *>(inner->child_list[position_left + 1]);
+				memcpy(target->key_list + target->count, source->key_list, source->count * sizeof(Key));
+				memcpy(target->value_list + target->count, source->value_list, source->count * sizeof(Value));
+				target->count += source->count;
+				target->next = source->next;
+				inner_remove_at(inner, position_left);
+				release_node(source);
+			}
+			return;
+		}
+
+		Inner * node = static_cast<Inner *>(child);
+		if (left != nullptr && left->count > INNER_MIN)
+		{
+			Inner * source = static_cast<Inner *>(left);
+			memmove(node->key_list + 1, node->key_list, node->count * sizeof(Key));
+			memmove(node->child_list + 1, node->child_list, (node->count + 1) * sizeof(Node *));
+			node->key_list[0] = inner->key_list[position - 1];
+			node->child_list[0] = source->child_list[source->count];
+			node->count++;
+			inner->key_list[position - 1] = source->key_list[source->count - 1];
+			source->count--;
+		}
+		else if (right != nullptr && right->count > INNER_MIN)
+		{
+			Inner * source = static_cast<Inner *>(right);
+			node->key_list[node->count] = inner->key_list[position];
+			node->child_list[node->count + 1] = source->child_list[0];
+			node->count++;
+			inner->key_list[position] = source->key_list[0];
+			memmove(source->key_list, source->key_list + 1, (source->count - 1) * sizeof(Key));
+			memmove(source->child_list, source->child_list + 1, source->count * sizeof(Node *));
+			source->count--;
+		}
+		else
+		{
+			size_t position_left = (left != nullptr) ? position - 1 : position;
+			Inner * target = static_cast<Inner *>(inner->child_list[position_left]);
+			Inner * source = static_cast<Inner *>(inner->child_list[position_left + 1]);
+			target->key_list[target->count] = inner->key_list[position_left];
+			memcpy(target->key_list + target->count + 1, source->key_list, source->count * sizeof(Key));
+			memcpy(target->child_list + target->count + 1, source->child_list, (source->count + 1) * sizeof(Node *));
+			target->count += source->count + 1;
+			inner_remove_at(inner, position_left);
+			release_node(source);
+		}
+	}
+
+	bool remove_from(Node * node, Key const & key)
+	{
+		if (node->is_leaf)
+		{
+			Leaf * leaf = static_cast<Leaf *>(node);
+			size_t position = lower_bound(leaf->key_list, leaf->count, key);
+			if (position == leaf->count || !is_equal(leaf->key_list[position], key)) {return false;}
+			leaf_remove_at(leaf, position);
+			return true;
+		}
+
+		Inner * inner = static_cast<Inner *>(node);
+		size_t position = upper_bound(inner->key_list, inner->count, key);
+		if (!remove_from(inner->child_list[position], key)) {return false;}
+		if (is_underfull(inner->child_list[position])) {fix_child(inner, position);}
+		return true;
+	}
+
+	void release_subtree(Node * node)
+	{
+		if (!node->is_leaf)
+		{
+			Inner * inner = static_cast<Inner *>(node);
+			for (size_t i = 0; i <= inner->count; i++)
+			{
+				release_subtree(inner->child_list[i]);
+			}
+		}
+		release_node(node);
+	}
+
+public:
+
+	BTreeMap(void) noexcept : m_alloc(nullptr) {}
+	BTreeMap(Alloc alloc, Free free, size_t slab_size_log2) : m_alloc(nullptr) {initialize(alloc, free, slab_size_log2);}
+	~BTreeMap(void) noexcept {uninitialize();}
+	BTreeMap(BTreeMap const &) = delete;
+	BTreeMap(BTreeMap &&) = delete;
+	void operator=(BTreeMap const &) = delete;
+	void operator=(BTreeMap &&) = delete;
+
+	bool is_initialized(void) const {return m_alloc != nullptr;}
+
+	void initialize(Alloc alloc, Free free, size_t slab_size_log2)
+	{
+		TX_ASSERT(!is_initialized());
+
+		m_free_head = nullptr;
+		m_slab_head = nullptr;
+		m_slab_size_log2 = slab_size_log2;
+		m_alloc = alloc;
+		m_free = free;
+
+		m_first_leaf = create_leaf();
+		m_root = m_first_leaf;
+		m_size = 0;
+		m_height = 0;
+	}
+
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+
+		while (m_slab_head != nullptr)
+		{
+			Slab * next = m_slab_head->next;
+			m_free(m_slab_head);
+			m_slab_head = next;
+		}
+		m_alloc = nullptr;
+	}
+
+	size_t get_size(void) const {return m_size;}
+	size_t get_height(void) const {return m_height + 1;}
+
+	Value * find(Key const & key)
+	{
+		Leaf * leaf = find_leaf(key);
+		size_t position = lower_bound(leaf->key_list, leaf->count, key);
+		if (position == leaf->count || !is_equal(leaf->key_list[position], key)) {return nullptr;}
+		return &leaf->value_list[position];
+	}
+
+	Iterator begin(void) const {return Iterator(m_first_leaf, 0);}
+	Iterator end(void) const {return Iterator();}
+
+	// First entry whose key is not smaller than @key
+	Iterator lower_bound(Key const & key) const
+	{
+		Leaf * leaf = find_leaf(key);
+		return Iterator(leaf, lower_bound(leaf->key_list, leaf->count, key));
+	}
+
+	// First entry whose key is larger than @key
+	Iterator upper_bound(Key const & key) const
+	{
+		Leaf * leaf = find_leaf(key);
+		return Iterator(leaf, upper_bound(leaf->key_list, leaf->count, key));
+	}
+
+	// Visit the entries with keys in [@low, @high) in order, as @visit(key, value)
+	template <typename Visit>
+	void for_each_in_range(Key const & low, Key const & high, Visit visit) const
+	{
+		Leaf * leaf = find_leaf(low);
+		size_t index = lower_bound(leaf->key_list, leaf->count, low);
+		while (leaf != nullptr)
+		{
+			for (; index < leaf->count; index++)
+			{
+				if (!(leaf->key_list[index] < high)) {return;}
+				visit(leaf->key_list[index], leaf->value_list[index]);
+			}
+			leaf = leaf->next;
+			index = 0;
+		}
+	}
+
+	// Replace current value if it exists
+	void insert(Key const & key, Value const & value)
+	{
+		TX_ASSERT(is_initialized());
+
+		Key split_key;
+		Node * split_node;
+		if (insert_into(m_root, key, value, split_key, split_node)) {m_size++;}
+		if (split_node != nullptr)
+		{
+			TX_ASSERT(m_height + 1 < HEIGHT_MAX);
+			Inner * root = create_inner();
+			root->count = 1;
+			root->key_list[0] = split_key;
+			root->child_list[0] = m_root;
+			root->child_list[1] = split_node;
+			m_root = root;
+			m_height++;
+		}
+	}
+
+	// Remove the key if it exists
+	bool remove(Key const & key)
+	{
+		if (!remove_from(m_root, key)) {return false;}
+		m_size--;
+		if (!m_root->is_leaf && m_root->count == 0)
+		{
+			Node * root = m_root;
+			m_root = static_cast<Inner *>(root)->child_list[0];
+			release_node(root);
+			m_height--;
+		}
+		return true;
+	}
+
+	// Build the tree from @count entries in strictly increasing key order; the tree must be empty
+	// Leaves and inner nodes are filled completely, from left to right, without any search
+	void bulk_load(Key const * key_list, Value const * value_list, size_t count)
+	{
+		TX_ASSERT(m_size == 0);
+		if (count == 0) {return;}
+
+		Inner * spine[HEIGHT_MAX];		// Rightmost node of each inner level
+		size_t height = 0;
+		Leaf * leaf = m_first_leaf;
+		for (size_t i = 0; i < count; i++)
+		{
+			TX_ASSERT(i == 0 || key_list[i - 1] < key_list[i]);
+			if (leaf->count == LEAF_CAPACITY)
+			{
+				Leaf * leaf_prev = leaf;
+				leaf = create_leaf();
+				leaf_prev->next = leaf;
+
+				// Append the new leaf to the rightmost nodes, starting new nodes up the spine where they are full
+				Node * child = leaf;
+				Node * child_prev = leaf_prev;
+				for (size_t level = 0; ; level++)
+				{
+					if (level == height)
+					{
+						TX_ASSERT(height + 1 < HEIGHT_MAX);
+						spine[level] = create_inner();
+						spine[level]->child_list[0] = child_prev;
+						height++;
+					}
+					Inner * inner = spine[level];
+					if (inner->count < INNER_CAPACITY)
+					{
+						inner->key_list[inner->count] = key_list[i];
+						inner->child_list[inner->count + 1] = child;
+						inner->count++;
+						break;
+					}
+					Inner * next_inner = create_inner();
+					next_inner->child_list[0] = child;
+					spine[level] = next_inner;
+					child = next_inner;
+					child_prev = inner;
+				}
+			}
+			leaf->key_list[leaf->count] = key_list[i];
+			leaf->value_list[leaf->count] = value_list[i];
+			leaf->count++;
+		}
+
+		m_size = count;
+		m_height = height;
+		m_root = (height == 0) ? (Node *) m_first_leaf : (Node *) spine[height - 1];
+
+		// Only the rightmost nodes may be underfull; refill them from their left siblings, from the top down
+		Node * node = m_root;
+		while (!node->is_leaf)
+		{
+			Inner * inner = static_cast<Inner *>(node);
+			while (is_underfull(inner->child_list[inner->count])) {fix_child(inner, inner->count);}
+			node = inner->child_list[inner->count];
+		}
+	}
+
+	void clear(void)
+	{
+		release_subtree(m_root);
+		m_first_leaf = create_leaf();
+		m_root = m_first_leaf;
+		m_size = 0;
+		m_height = 0;
+	}
+};
+
+
+
+}
@@ -0,0 +1,18 @@
+/*
+ * tx_cacheline.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+
+// Alignment that keeps data written by different cores on separate cache lines
+#if defined(__arm__)
+static constexpr size_t const TX_CACHE_LINE_SIZE = 32;
+#else
+static constexpr size_t const TX_CACHE_LINE_SIZE = 64;
+#endif
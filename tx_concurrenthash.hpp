@@ -0,0 +1,379 @@
+/*
+ * tx_concurrenthash.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+#include "tx_assert.h"
+#include "tx_spinlock.hpp"
+#include "tx_cacheline.hpp"
+#include "tx_epoch.hpp"
+
+namespace TXLib
+{
+
+template <size_t SIZE> struct RelaxedWord {};
+template <> struct RelaxedWord<1> {typedef uint8_t __attribute__((__may_alias__)) Type;};
+template <> struct RelaxedWord<2> {typedef uint16_t __attribute__((__may_alias__)) Type;};
+template <> struct RelaxedWord<4> {typedef uint32_t __attribute__((__may_alias__)) Type;};
+template <> struct RelaxedWord<8> {typedef uint64_t __attribute__((__may_alias__)) Type;};
+
+template <typename Type>
+constexpr size_t get_relaxed_word_size(void)
+// Largest word, at most a machine word, that tiles @Type at its alignment
+{
+	size_t size = sizeof(size_t);
+	while (size > 1 && (sizeof(Type) % size != 0 || alignof(Type) < size)) {size /= 2;}
+	return size;
+}
+
+// Copy @source to @target word by word with relaxed atomic loads
+// For a trivially copyable object that a writer may modify concurrently: the copy may be torn and must be validated by other means
+template <typename Type>
+inline void load_relaxed(Type & target, Type const & source)
+{
+	static_assert(std::is_trivially_copyable<Type>::value);
+	typedef typename RelaxedWord<get_relaxed_word_size<Type>()>::Type Word;
+	Word * target_word = (Word *) &target;
+	Word const * source_word = (Word const *) &source;
+	for (size_t i = 0; i < sizeof(Type) / sizeof(Word); i++)
+	{
+		target_word[i] = __atomic_load_n(source_word + i, __ATOMIC_RELAXED);
+	}
+}
+
+// Copy @source to @target word by word with relaxed atomic stores, for an object that readers may copy with load_relaxed()
+template <typename Type>
+inline void store_relaxed(Type & target, Type const & source)
+{
+	static_assert(std::is_trivially_copyable<Type>::value);
+	typedef typename RelaxedWord<get_relaxed_word_size<Type>()>::Type Word;
+	Word * target_word = (Word *) &target;
+	Word const * source_word = (Word const *) &source;
+	for (size_t i = 0; i < sizeof(Type) / sizeof(Word); i++)
+	{
+		__atomic_store_n(target_word + i, source_word[i], __ATOMIC_RELAXED);
+	}
+}
+
+
+// Open addressing hash table for many readers and few writers
+// The table is split into 2^SEGMENT_COUNT_LOG2 segments, each an independent resizable table with conflict resolution by linear search
+// Writers serialize on the lock of the segment they modify
+// Readers take no lock: they copy the entry out with relaxed atomic loads and validate the copy against the sequence number of the segment (seqlock),
+// retrying if a writer intervened; writers store entries with relaxed atomic stores
+// A growing segment publishes a new table; the old one is reclaimed through epochs once no reader can access it
+// Growth copies every entry of the segment while its lock is held: the insertion that triggers it is O(segment size) and blocks the other writers
+// of the segment, though not the readers. Choose the segment capacity for the expected size to avoid growth on latency-sensitive paths
+// @hash_func may return any value; its low bits select the segment and the next bits select the slot
+template <typename Key, typename Value, Key const & KEY_INVALID, size_t hash_func(Key), size_t SEGMENT_COUNT_LOG2>
+class ConcurrentHashTable
+{
+	static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value); // Readers may copy entries that are being modified
+
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+private:
+
+	static constexpr size_t const SEGMENT_COUNT = 1u << SEGMENT_COUNT_LOG2;
+	static constexpr size_t const INDEX_INVALID = (size_t)(-1);
+
+	struct Table
+	{
+		EpochRetired		retired; // Must be the first member
+		Free						free;
+		size_t					mask;			// Capacity - 1
+		Key *						key_list;
+		Value *					value_list;
+	};
+
+	struct alignas(TX_CACHE_LINE_SIZE) Segment
+	{
+		Spinlock									lock;				// Held by writers
+		std::atomic<size_t>				sequence;		// Odd while a writer modifies the table in place
+		std::atomic<Table *>			table;
+		std::atomic<size_t>				size;				// Only modified by writers
+		size_t										max_size;		// Size that triggers growth
+	};
+
+private:
+
+	Segment				m_segment_list[SEGMENT_COUNT];
+	mutable EpochDomain		m_epoch;
+	size_t				m_max_load_percent;
+
+	Alloc					m_alloc;
+	Free					m_free;
+
+private:
+
+	static size_t slot_hash(size_t hash) {return hash >> SEGMENT_COUNT_LOG2;}
+
+	Segment & get_segment(size_t hash) {return m_segment_list[hash & (SEGMENT_COUNT - 1)];}
+	Segment const & get_segment(size_t hash) const {return m_segment_list[hash & (SEGMENT_COUNT - 1)];}
+
+	static size_t compute_distance(Table const * table, size_t index)
+	{
+		return (index - slot_hash(hash_func(table->key_list[index]))) & table->mask;
+	}
+
+	Table * allocate_table(size_t capacity_log2)
+	{
+		size_t capacity = 1u << capacity_log2;
+		Table * table = (Table *) m_alloc(sizeof(Table));
+		table->free = m_free;
+		table->mask = capacity - 1;
+		table->key_list = (Key *) m_alloc(capacity * sizeof(Key));
+		table->value_list = (Value *) m_alloc(capacity * sizeof(Value));
+		for (size_t i = 0; i < capacity; i++)
+		{
+			table->key_list[i] = KEY_INVALID;
+		}
+		return table;
+	}
+
+	static void free_table(EpochRetired * retired)
+	{
+		Table * table = (Table *) retired;
+		Free free = table->free;
+		free(table->key_list);
+		free(table->value_list);
+		free(table);
+	}
+
+	static size_t find_index(Table const * table, Key const & key)
+	{
+		size_t index = slot_hash(hash_func(key)) & table->mask;
+		while (table->key_list[index] != key)
+		{
+			if (table->key_list[index] == KEY_INVALID) {return INDEX_INVALID;}
+			index = (index + 1) & table->mask;
+		}
+		return index;
+	}
+
+	static void insert_new(Table * table, Key const & key, Value const & value)
+	// @key must not be in the table
+	{
+		size_t index = slot_hash(hash_func(key)) & table->mask;
+		while (table->key_list[index] != KEY_INVALID)
+		{
+			index = (index + 1) & table->mask;
+		}
+		store_relaxed(table->value_list[index], value);
+		store_relaxed(table->key_list[index], key);
+	}
+
+	static void begin_write(Segment & segment)
+	{
+		segment.sequence.store(segment.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release); // The odd sequence number is visible before any modification
+	}
+
+	static void end_write(Segment & segment)
+	{
+		segment.sequence.store(segment.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	void grow_segment(Segment & segment)
+	// The lock of @segment must be held
+	// The old table is not modified, hence readers need not retry
+	{
+		Table * table_old = segment.table.load(std::memory_order_relaxed);
+		Table * table = allocate_table(__builtin_ctz(table_old->mask + 1) + 1);
+		for (size_t i = 0; i <= table_old->mask; i++)
+		{
+			if (table_old->key_list[i] != KEY_INVALID)
+			{
+				insert_new(table, table_old->key_list[i], table_old->value_list[i]);
+			}
+		}
+		segment.max_size = (table->mask + 1) * m_max_load_percent / 100;
+		segment.table.store(table, std::memory_order_release);
+
+		m_epoch.retire(&table_old->retired, free_table);
+	}
+
+public:
+
+	ConcurrentHashTable(void) noexcept : m_alloc(nullptr) {}
+	ConcurrentHashTable(Alloc alloc, Free free, size_t segment_capacity_log2, size_t max_load_percent) : m_alloc(nullptr) {initialize(alloc, free, segment_capacity_log2, max_load_percent);}
+	~ConcurrentHashTable(void) noexcept {uninitialize();}
+	ConcurrentHashTable(ConcurrentHashTable<Key, Value, KEY_INVALID, hash_func, SEGMENT_COUNT_LOG2> const &) = delete;
+	ConcurrentHashTable(ConcurrentHashTable<Key, Value, KEY_INVALID, hash_func, SEGMENT_COUNT_LOG2> &&) = delete;
+	void operator=(ConcurrentHashTable<Key, Value, KEY_INVALID, hash_func, SEGMENT_COUNT_LOG2> const &) = delete;
+	void operator=(ConcurrentHashTable<Key, Value, KEY_INVALID, hash_func, SEGMENT_COUNT_LOG2> &&) = delete;
+
+	bool is_initialized(void) const {return m_alloc != nullptr;}
+
+	// Not thread-safe
+	void initialize(Alloc alloc, Free free, size_t segment_capacity_log2, size_t max_load_percent)
+	{
+		TX_ASSERT(!is_initialized());
+		TX_ASSERT(max_load_percent > 0 && max_load_percent < 100);
+
+		m_alloc = alloc;
+		m_free = free;
+		m_max_load_percent = max_load_percent;
+
+		for (size_t i = 0; i < SEGMENT_COUNT; i++)
+		{
+			Segment & segment = m_segment_list[i];
+			segment.sequence.store(0, std::memory_order_relaxed);
+			segment.table.store(allocate_table(segment_capacity_log2), std::memory_order_relaxed);
+			segment.size.store(0, std::memory_order_relaxed);
+			segment.max_size = (1u << segment_capacity_log2) * m_max_load_percent / 100;
+		}
+	}
+
+	// Not thread-safe
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+
+		m_epoch.reclaim_all();
+		for (size_t i = 0; i < SEGMENT_COUNT; i++)
+		{
+			free_table(&m_segment_list[i].table.load(std::memory_order_relaxed)->retired);
+		}
+		m_alloc = nullptr;
+	}
+
+	// Approximate while writers are active
+	size_t get_size(void) const
+	{
+		size_t size = 0;
+		for (size_t i = 0; i < SEGMENT_COUNT; i++)
+		{
+			size += m_segment_list[i].size.load(std::memory_order_relaxed);
+		}
+		return size;
+	}
+
+	// Lock-free
+	// Return true and copy the value to @value if the key exists
+	bool find(Key const & key, Value & value) const
+	{
+		size_t hash = hash_func(key);
+		Segment const & segment = get_segment(hash);
+		size_t ticket = m_epoch.enter();
+
+		bool is_found;
+		while (1)
+		{
+			size_t sequence = segment.sequence.load(std::memory_order_acquire);
+			if (sequence & 0b1u) {continue;} // A writer is modifying the table
+
+			Table const * table = segment.table.load(std::memory_order_acquire);
+			size_t index = slot_hash(hash) & table->mask;
+			is_found = false;
+			for (size_t i = 0; i <= table->mask; i++) // Bounded since a torn read may not see any empty slot
+			{
+				Key key_read = KEY_INVALID;
+				load_relaxed(key_read, table->key_list[index]);
+				if (key_read == key)
+				{
+					load_relaxed(value, table->value_list[index]);
+					is_found = true;
+					break;
+				}
+				if (key_read == KEY_INVALID) {break;}
+				index = (index + 1) & table->mask;
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire); // The reads above complete before the sequence number is checked
+			if (segment.sequence.load(std::memory_order_relaxed) == sequence) {break;}
+		}
+
+		m_epoch.exit(ticket);
+		return is_found;
+	}
+
+	// Replace current value if it exists
+	void insert(Key const & key, Value const & value)
+	{
+		TX_ASSERT(key != KEY_INVALID);
+
+		size_t hash = hash_func(key);
+		Segment & segment = get_segment(hash);
+		segment.lock.acquire();
+
+		Table * table = segment.table.load(std::memory_order_relaxed);
+		size_t index = find_index(table, key);
+		if (index == INDEX_INVALID && segment.size.load(std::memory_order_relaxed) >= segment.max_size)
+		{
+			grow_segment(segment);
+			table = segment.table.load(std::memory_order_relaxed);
+		}
+
+		begin_write(segment);
+		if (index != INDEX_INVALID)
+		{
+			store_relaxed(table->value_list[index], value);
+		}
+		else
+		{
+			insert_new(table, key, value);
+			segment.size.store(segment.size.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+		end_write(segment);
+
+		segment.lock.release();
+	}
+
+	// Remove the key if it exists
+	void remove(Key const & key)
+	{
+		TX_ASSERT(key != KEY_INVALID);
+
+		size_t hash = hash_func(key);
+		Segment & segment = get_segment(hash);
+		segment.lock.acquire();
+
+		Table * table = segment.table.load(std::memory_order_relaxed);
+		size_t index_remove = find_index(table, key);
+		if (index_remove != INDEX_INVALID)
+		{
+			begin_write(segment);
+
+			// Shift table up
+			size_t distance = 1;
+			size_t index_replace = (index_remove + 1) & table->mask;
+			while (table->key_list[index_replace] != KEY_INVALID)
+			{
+				if (compute_distance(table, index_replace) >= distance)
+				{
+					store_relaxed(table->key_list[index_remove], table->key_list[index_replace]);
+					store_relaxed(table->value_list[index_remove], table->value_list[index_replace]);
+					distance = 0;
+					index_remove = index_replace;
+				}
+				distance ++;
+				index_replace = (index_replace + 1) & table->mask;
+			}
+			store_relaxed(table->key_list[index_remove], KEY_INVALID);
+			segment.size.store(segment.size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+			end_write(segment);
+		}
+
+		segment.lock.release();
+	}
+
+	// Reclaim old tables that are no longer accessible by readers
+	void collect(void) {m_epoch.collect();}
+
+};
+
+
+
+}
@@ -0,0 +1,193 @@
+/*
+ * tx_epoch.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "tx_assert.h"
+#include "tx_cacheline.hpp"
+
+namespace TXLib
+{
+
+// Header embedded (as first member) in objects that are retired to an EpochDomain
+struct EpochRetired
+{
+	EpochRetired *		next;
+	size_t						epoch;			// Epoch in which the object was retired
+	void							(*reclaim)(EpochRetired *);
+};
+
+
+// Epoch-based reclamation for data structures with lock-free readers
+// A reader enters the domain before loading shared pointers and exits after its last access through them
+// An object unlinked by a writer is retired; it is reclaimed once every reader that could have seen it has exited
+// Active readers are counted by the parity of the epoch they entered in; the epoch only advances past E once the readers of E - 1 have exited,
+// so an object retired in epoch E can be reclaimed in epoch E + 2
+// The counts are spread over reader slots on separate cache lines, so that readers on different cores do not write to the same line;
+// readers only load the shared epoch
+// Retiring and collecting take no lock; a collection that finds another one in progress leaves the work to it
+class EpochDomain
+{
+private:
+#if defined(__arm__)
+	static constexpr size_t const READER_SLOT_COUNT_LOG2 = 2;
+#else
+	static constexpr size_t const READER_SLOT_COUNT_LOG2 = 4;
+#endif
+	static constexpr size_t const READER_SLOT_COUNT = 1u << READER_SLOT_COUNT_LOG2;
+
+	struct alignas(TX_CACHE_LINE_SIZE) ReaderSlot
+	{
+		std::atomic<size_t>		count[2];		// Readers by parity of their epoch
+	};
+
+private:
+	alignas(TX_CACHE_LINE_SIZE) std::atomic<size_t>		m_epoch;
+	ReaderSlot																				m_slot_list[READER_SLOT_COUNT];
+	alignas(TX_CACHE_LINE_SIZE) std::atomic<EpochRetired *>		m_retired_head;
+	std::atomic<bool>																	m_is_collecting;
+
+private:
+	static size_t get_reader_slot(void)
+	// Threads run on separate stacks; the address of a local variable spreads them over the slots without thread-local storage
+	// Sharing a slot is always correct, only slower
+	{
+		uint8_t local;
+		uint32_t address = (uint32_t)((size_t) &local >> 10);
+		return (uint32_t)(address * 0x9E3779B9u) >> (32 - READER_SLOT_COUNT_LOG2);
+	}
+
+	size_t count_readers(size_t parity) const
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < READER_SLOT_COUNT; i++)
+		{
+			count += m_slot_list[i].count[parity].load();
+		}
+		return count;
+	}
+
+	void push_retired(EpochRetired * head, EpochRetired * tail)
+	{
+		EpochRetired * next = m_retired_head.load(std::memory_order_relaxed);
+		do
+		{
+			tail->next = next;
+		}
+		while (!m_retired_head.compare_exchange_weak(next, head, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+public:
+	EpochDomain(void) noexcept : m_epoch(0), m_retired_head(nullptr), m_is_collecting(false)
+	{
+		for (size_t i = 0; i < READER_SLOT_COUNT; i++)
+		{
+			m_slot_list[i].count[0].store(0, std::memory_order_relaxed);
+			m_slot_list[i].count[1].store(0, std::memory_order_relaxed);
+		}
+	}
+	EpochDomain(EpochDomain const &) = delete;
+	EpochDomain(EpochDomain &&) = delete;
+	~EpochDomain(void) noexcept {TX_ASSERT(m_retired_head.load() == nullptr);}
+	void operator=(EpochDomain const &) = delete;
+	void operator=(EpochDomain &&) = delete;
+
+	// Return the ticket to be passed to exit()
+	// Sequentially consistent ordering guarantees that shared pointers are loaded after the reader is counted
+	size_t enter(void)
+	{
+		size_t slot = get_reader_slot();
+		while (1)
+		{
+			size_t epoch = m_epoch.load();
+			m_slot_list[slot].count[epoch & 0b1u].fetch_add(1);
+			if (m_epoch.load() == epoch) {return (slot << 1) | (epoch & 0b1u);}
+			m_slot_list[slot].count[epoch & 0b1u].fetch_sub(1); // The epoch advanced in between; the reader must be counted in the new epoch
+		}
+	}
+
+	void exit(size_t ticket)
+	{
+		m_slot_list[ticket >> 1].count[ticket & 0b1u].fetch_sub(1, std::memory_order_release);
+	}
+
+	// @object must already be unreachable for readers entering from now on
+	void retire(EpochRetired * object, void reclaim_func(EpochRetired *))
+	{
+		object->reclaim = reclaim_func;
+		object->epoch = m_epoch.load();
+		push_retired(object, object);
+
+		collect();
+	}
+
+	// Advance the epoch as far as the readers allow, then reclaim the eligible retired objects
+	// Objects are reclaimed by the thread that collects them
+	void collect(void)
+	{
+		if (m_is_collecting.exchange(true, std::memory_order_acquire)) {return;}
+
+		for (size_t i = 0; i < 2; i++)
+		{
+			size_t epoch = m_epoch.load();
+			if (count_readers((epoch + 1) & 0b1u) != 0) {break;}
+			m_epoch.store(epoch + 1);
+		}
+
+		size_t epoch = m_epoch.load();
+		EpochRetired * reclaimable = nullptr;
+		EpochRetired * kept_head = nullptr;
+		EpochRetired * kept_tail = nullptr;
+		EpochRetired * object = m_retired_head.exchange(nullptr, std::memory_order_acquire);
+		while (object != nullptr)
+		{
+			EpochRetired * next = object->next;
+			if (epoch - object->epoch >= 2)
+			{
+				object->next = reclaimable;
+				reclaimable = object;
+			}
+			else
+			{
+				object->next = kept_head;
+				kept_head = object;
+				if (kept_tail == nullptr) {kept_tail = object;}
+			}
+			object = next;
+		}
+		if (kept_head != nullptr) {push_retired(kept_head, kept_tail);}
+
+		m_is_collecting.store(false, std::memory_order_release);
+
+		while (reclaimable != nullptr)
+		{
+			EpochRetired * next = reclaimable->next;
+			reclaimable->reclaim(reclaimable);
+			reclaimable = next;
+		}
+	}
+
+	// Reclaim every retired object; there cannot be any reader
+	void reclaim_all(void)
+	{
+		TX_ASSERT(count_readers(0) == 0 && count_readers(1) == 0);
+		EpochRetired * object = m_retired_head.exchange(nullptr);
+		while (object != nullptr)
+		{
+			EpochRetired * next = object->next;
+			object->reclaim(object);
+			object = next;
+		}
+	}
+};
+
+
+
+}
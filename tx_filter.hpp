@@ -0,0 +1,346 @@
+/*
+ * tx_filter.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "tx_assert.h"
+#include "tx_hash.hpp"
+#include "tx_hashfunc.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace TXLib
+{
+
+// Approximate membership filters, to skip the probing of a hash table for most keys that are absent
+// A filter answers "maybe present" or "certainly absent"; the caller supplies a 64-bit hash of good quality (see tx_hashfunc.hpp)
+
+
+// Split block Bloom filter
+// Each key sets one bit in each of the 8 words of a single 32-byte block, so a test touches one cache line (two on a 64-byte line at worst)
+// About 8 bits per key give a false positive rate near 2%, 16 bits per key near 0.1%
+// Keys cannot be removed
+template <size_t BLOCK_COUNT>
+class BloomFilter
+{
+public:
+
+	static constexpr bool const IS_REMOVABLE = false;
+
+private:
+
+	static constexpr size_t const WORD_COUNT = 8;
+	static constexpr uint32_t const SALT[WORD_COUNT] = {0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u};
+
+	struct alignas(32) Block
+	{
+		uint32_t		word_list[WORD_COUNT];
+	};
+
+private:
+
+	Block				m_block_list[BLOCK_COUNT];
+
+private:
+
+	static size_t get_block_index(uint64_t hash) {return reduce_range((uint32_t)(hash >> 32), BLOCK_COUNT);}
+
+	// One bit per word, chosen by the top 5 bits of the low half of the hash multiplied by a different odd salt
+	static void make_mask(uint64_t hash, uint32_t * mask)
+	{
+		for (size_t i = 0; i < WORD_COUNT; i++)
+		{
+			mask[i] = (uint32_t) 1u << (((uint32_t) hash * SALT[i]) >> 27);
+		}
+	}
+
+public:
+
+	BloomFilter(void) {clear();}
+
+	void clear(void) {memset(m_block_list, 0, sizeof(m_block_list));}
+
+	// Always succeeds
+	bool insert(uint64_t hash)
+	{
+		Block & block = m_block_list[get_block_index(hash)];
+		uint32_t mask[WORD_COUNT];
+		make_mask(hash, mask);
+		for (size_t i = 0; i < WORD_COUNT; i++)
+		{
+			block.word_list[i] |= mask[i];
+		}
+		return true;
+	}
+
+	bool may_contain(uint64_t hash) const
+	{
+		Block const & block = m_block_list[get_block_index(hash)];
+		uint32_t mask[WORD_COUNT];
+		make_mask(hash, mask);
+#if defined(__SSE2__)
+		// The block contains the mask iff (~block & mask) is zero in every word
+		__m128i low = _mm_andnot_si128(_mm_load_si128((__m128i const *) block.word_list), _mm_loadu_si128((__m128i const *) mask));
+		__m128i high = _mm_andnot_si128(_mm_load_si128((__m128i const *) (block.word_list + 4)), _mm_loadu_si128((__m128i const *) (mask + 4)));
+		__m128i missing = _mm_or_si128(low, high);
+		return _mm_movemask_epi8(_mm_cmpeq_epi32(missing, _mm_setzero_si128())) == 0xFFFF;
+#elif defined(__ARM_NEON)
+		uint32x4_t low = vbicq_u32(vld1q_u32(mask), vld1q_u32(block.word_list));
+		uint32x4_t high = vbicq_u32(vld1q_u32(mask + 4), vld1q_u32(block.word_list + 4));
+		uint32x4_t missing = vorrq_u32(low, high);
+		uint32x2_t folded = vorr_u32(vget_low_u32(missing), vget_high_u32(missing));
+		return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) == 0;
+#else
+		uint32_t missing = 0;
+		for (size_t i = 0; i < WORD_COUNT; i++)
+		{
+			missing |= mask[i] & ~block.word_list[i];
+		}
+		return missing == 0;
+#endif
+	}
+};
+
+
+// Cuckoo filter with 4 slots of 16-bit fingerprints per bucket (partial-key cuckoo hashing)
+// A key may be in its bucket or in the alternate bucket, derived from the bucket and the fingerprint only, so that keys can be relocated and removed
+// The false positive rate is near 0.01% up to a load of 95%; insert() fails once the filter is nearly full
+// Only keys that have been inserted may be removed
+template <size_t BUCKET_COUNT_LOG2>
+class CuckooFilter
+{
+public:
+
+	static constexpr bool const IS_REMOVABLE = true;
+
+private:
+
+	static constexpr size_t const BUCKET_COUNT = 1u << BUCKET_COUNT_LOG2;
+	static constexpr size_t const SLOT_COUNT = 4;
+	static constexpr size_t const KICK_LIMIT = 500;
+	static constexpr uint16_t const FINGERPRINT_EMPTY = 0;
+
+	struct Bucket
+	{
+		uint16_t		fingerprint_list[SLOT_COUNT];
+	};
+
+private:
+
+	Bucket			m_bucket_list[BUCKET_COUNT];
+	size_t			m_size;
+	uint32_t		m_random;			// State of the generator choosing the fingerprint to kick out
+
+	// A fingerprint that could not be placed after KICK_LIMIT relocations; keeps the filter free of false negatives
+	bool				m_has_victim;
+	uint16_t		m_victim_fingerprint;
+	size_t			m_victim_index;
+
+private:
+
+	static uint16_t get_fingerprint(uint64_t hash)
+	{
+		uint16_t fingerprint = (uint16_t)(hash >> 48);
+		return (fingerprint == FINGERPRINT_EMPTY) ? 1 : fingerprint;
+	}
+
+	static size_t get_index(uint64_t hash) {return (size_t) hash & (BUCKET_COUNT - 1);}
+	static size_t get_alternate_index(size_t index, uint16_t fingerprint) {return (index ^ hash_u32(fingerprint)) & (BUCKET_COUNT - 1);}
+
+	bool bucket_contains(size_t index, uint16_t fingerprint) const
+	{
+		Bucket const & bucket = m_bucket_list[index];
+		return bucket.fingerprint_list[0] == fingerprint || bucket.fingerprint_list[1] == fingerprint
+				|| bucket.fingerprint_list[2] == fingerprint || bucket.fingerprint_list[3] == fingerprint;
+	}
+
+	bool bucket_insert(size_t index, uint16_t fingerprint)
+	{
+		for (size_t i = 0; i < SLOT_COUNT; i++)
+		{
+			if (m_bucket_list[index].fingerprint_list[i] == FINGERPRINT_EMPTY)
+			{
+				m_bucket_list[index].fingerprint_list[i] = fingerprint;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool bucket_remove(size_t index, uint16_t fingerprint)
+	{
+		for (size_t i = 0; i < SLOT_COUNT; i++)
+		{
+			if (m_bucket_list[index].fingerprint_list[i] == fingerprint)
+			{
+				m_bucket_list[index].fingerprint_list[i] = FINGERPRINT_EMPTY;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void place(size_t index, uint16_t fingerprint)
+	{
+		size_t index_alternate = get_alternate_index(index, fingerprint);
+		if (bucket_insert(index, fingerprint) || bucket_insert(index_alternate, fingerprint)) {return;}
+
+		// Relocate fingerprints along a random path until one finds a free slot
+		index = (next_random() & 0b1u) ? index : index_alternate;
+		for (size_t kick = 0; kick < KICK_LIMIT; kick++)
+		{
+			uint16_t & slot = m_bucket_list[index].fingerprint_list[next_random() & (SLOT_COUNT - 1)];
+			uint16_t temp = slot;
+			slot = fingerprint;
+			fingerprint = temp;
+			index = get_alternate_index(index, fingerprint);
+			if (bucket_insert(index, fingerprint)) {return;}
+		}
+
+		// The last fingerprint kicked out is kept aside; further insertions are refused
+		m_has_victim = true;
+		m_victim_fingerprint = fingerprint;
+		m_victim_index = index;
+	}
+
+	size_t next_random(void)
+	{
+		// xorshift32
+		m_random ^= m_random << 13;
+		m_random ^= m_random >> 17;
+		m_random ^= m_random << 5;
+		return m_random;
+	}
+
+public:
+
+	CuckooFilter(void) : m_random(0x9E3779B9u) {clear();}
+
+	size_t get_size(void) const {return m_size;}
+
+	void clear(void)
+	{
+		memset(m_bucket_list, 0, sizeof(m_bucket_list));
+		m_size = 0;
+		m_has_victim = false;
+	}
+
+	// Return false if the filter is full; the filter is then unchanged
+	bool insert(uint64_t hash)
+	{
+		if (m_has_victim) {return false;}
+
+		m_size++;
+		place(get_index(hash), get_fingerprint(hash));
+		return true;
+	}
+
+	bool may_contain(uint64_t hash) const
+	{
+		uint16_t fingerprint = get_fingerprint(hash);
+		size_t index = get_index(hash);
+		size_t index_alternate = get_alternate_index(index, fingerprint);
+		if (bucket_contains(index, fingerprint) || bucket_contains(index_alternate, fingerprint)) {return true;}
+		return m_has_victim && m_victim_fingerprint == fingerprint
+				&& (m_victim_index == index || m_victim_index == index_alternate);
+	}
+
+	// @hash must be of a key that has been inserted
+	void remove(uint64_t hash)
+	{
+		uint16_t fingerprint = get_fingerprint(hash);
+		size_t index = get_index(hash);
+		size_t index_alternate = get_alternate_index(index, fingerprint);
+		TX_ASSERT(m_size > 0);
+		m_size--;
+
+		if (m_has_victim && m_victim_fingerprint == fingerprint && (m_victim_index == index || m_victim_index == index_alternate))
+		{
+			m_has_victim = false;
+			return;
+		}
+		bool is_removed = bucket_remove(index, fingerprint) || bucket_remove(index_alternate, fingerprint);
+		TX_ASSERT(is_removed);
+
+		// Room has been made for the victim
+		if (m_has_victim)
+		{
+			m_has_victim = false;
+			place(m_victim_index, m_victim_fingerprint);
+		}
+	}
+};
+
+
+// HashTable that consults a filter before probing, so that most lookups of absent keys do not touch the table
+// @filter_hash must be independent of the hash_func of the table
+// With a filter that cannot remove keys, removed keys only raise the false positive rate until clear()
+template <typename Key, typename Value, size_t CAPACITY, Key const & KEY_INVALID, size_t hash_func(Key), typename Filter, uint64_t filter_hash(Key const &) = hash_value<Key>>
+class FilteredHashTable
+{
+private:
+
+	HashTable<Key, Value, CAPACITY, KEY_INVALID, hash_func>			m_table;
+	Filter																										m_filter;
+
+public:
+
+	size_t get_size(void) const {return m_table.get_size();}
+	size_t get_capacity(void) const {return CAPACITY;}
+
+	HashTable<Key, Value, CAPACITY, KEY_INVALID, hash_func> const & get_table(void) const {return m_table;}
+	Filter const & get_filter(void) const {return m_filter;}
+
+	Value * find(Key const & key)
+	{
+		if (!m_filter.may_contain(filter_hash(key))) {return nullptr;}
+		return m_table.find(key);
+	}
+
+	void clear(void)
+	{
+		m_table.clear();
+		m_filter.clear();
+	}
+
+	// Replace current value if it exists
+	// Return false if the filter is full; the table is then unchanged
+	bool insert(Key const & key, Value const & value)
+	{
+		Value * existing = m_table.find(key);
+		if (existing != nullptr)
+		{
+			*existing = value;
+			return true;
+		}
+		if (!m_filter.insert(filter_hash(key))) {return false;}
+		m_table.insert(key, value);
+		return true;
+	}
+
+	// Remove the key if it exists
+	void remove(Key const & key)
+	{
+		if constexpr (Filter::IS_REMOVABLE)
+		{
+			if (m_table.find(key) == nullptr) {return;}
+			m_filter.remove(filter_hash(key));
+		}
+		m_table.remove(key);
+	}
+};
+
+
+
+}
@@ -8,23 +8,449 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <cstring>
+#include <utility>
+#include <new>
+#include <type_traits>
 #include "tx_assert.h"
+#include "tx_linkedlist.hpp"
+#include "tx_hashfunc.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace TXLib
 {
 
 
+// A group of consecutive control bytes of an open addressing table, compared in parallel
+// A control byte is either EMPTY or a 7-bit tag of the key stored in the slot
+// Matching slots are reported as a bit mask in which the bits of lower slots are less significant
+class HashControlGroup
+{
+public:
+
+	static constexpr uint8_t const EMPTY = 0x80;
+
+#if defined(__SSE2__)
+	static constexpr size_t const SIZE = 16;
+	typedef uint32_t Mask;
+	static constexpr size_t const MASK_BITS_PER_SLOT_LOG2 = 0;
+#elif defined(__ARM_NEON)
+	static constexpr size_t const SIZE = 16;
+	typedef uint64_t Mask;
+	static constexpr size_t const MASK_BITS_PER_SLOT_LOG2 = 2;
+#else
+	// Portable SWAR (SIMD within a register) implementation
+	static constexpr size_t const SIZE = 4;
+	typedef uint32_t Mask;
+	static constexpr size_t const MASK_BITS_PER_SLOT_LOG2 = 3;
+#endif
+
+private:
+
+#if defined(__SSE2__)
+	__m128i				m_control;
+#elif defined(__ARM_NEON)
+	uint8x16_t		m_control;
+
+	static Mask to_mask(uint8x16_t compare)
+	{
+		// Narrow every byte to a nibble and keep one bit per slot
+		uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(compare), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ull;
+	}
+#else
+	uint32_t			m_control;
+#endif
+
+public:
+
+	explicit HashControlGroup(uint8_t const * control)
+	{
+#if defined(__SSE2__)
+		m_control = _mm_loadu_si128((__m128i const *) control);
+#elif defined(__ARM_NEON)
+		m_control = vld1q_u8(control);
+#else
+		std::memcpy(&m_control, control, sizeof(m_control)); // Little-endian byte order is assumed
+#endif
+	}
+
+	// Slots whose control byte equals @tag
+	// The SWAR implementation may report false positives (never at an empty slot); the keys must be compared anyway
+	Mask match(uint8_t tag) const
+	{
+#if defined(__SSE2__)
+		return (Mask) _mm_movemask_epi8(_mm_cmpeq_epi8(m_control, _mm_set1_epi8((char) tag)));
+#elif defined(__ARM_NEON)
+		return to_mask(vceqq_u8(m_control, vdupq_n_u8(tag)));
+#else
+		uint32_t x = m_control ^ (0x01010101u * tag);
+		return (x - 0x01010101u) & ~x & 0x80808080u;
+#endif
+	}
+
+	Mask match_empty(void) const
+	{
+#if defined(__SSE2__)
+		return (Mask) _mm_movemask_epi8(m_control);
+#elif defined(__ARM_NEON)
+		return to_mask(vcltq_s8(vreinterpretq_s8_u8(m_control), vdupq_n_s8(0)));
+#else
+		return m_control & 0x80808080u;
+#endif
+	}
+
+	static Mask slots_before(Mask mask)
+	// Slots before the lowest slot of @mask (every slot if @mask is empty)
+	{
+		return (mask == 0) ? ~((Mask) 0) : ((mask & (~mask + 1)) - 1);
+	}
+
+	static size_t lowest_slot(Mask mask)
+	{
+		TX_ASSERT(mask != 0);
+		return ((sizeof(Mask) > sizeof(unsigned int)) ? __builtin_ctzll(mask) : __builtin_ctz(mask)) >> MASK_BITS_PER_SLOT_LOG2;
+	}
+
+	static Mask remove_lowest_slot(Mask mask) {return mask & (mask - 1);}
+};
+
+
+// Lazy reset of the slots of a hash table
+// Slots are grouped in blocks of BLOCK_SIZE, each stamped with the epoch in which it was last reset
+// Clearing the table only starts a new epoch; a block is reset by the table when it is first written in the new epoch,
+// and read as reset until then
+// Stamps are only rewritten all at once when the epoch wraps around, and at construction
+template <size_t SLOT_COUNT, size_t BLOCK_SIZE>
+class HashEpochBlocks
+{
+private:
+	static constexpr size_t const BLOCK_COUNT = (SLOT_COUNT + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+private:
+	uint8_t			m_stamp_list[BLOCK_COUNT];
+	uint8_t			m_epoch;	// Never 0, so that blocks stamped 0 are always stale
+
+public:
+	HashEpochBlocks(void) : m_epoch(1) {std::memset(m_stamp_list, 0, BLOCK_COUNT);}
+
+	static size_t get_block_begin(size_t index) {return index - index % BLOCK_SIZE;}
+	static size_t get_block_end(size_t index) {size_t end = get_block_begin(index) + BLOCK_SIZE; return (end < SLOT_COUNT) ? end : SLOT_COUNT;}
+
+	// Return true if the block of @index has been reset in the current epoch
+	bool is_current(size_t index) const {return m_stamp_list[index / BLOCK_SIZE] == m_epoch;}
+
+	// Return true if the block of @index has not been reset in the current epoch; it is then considered reset
+	bool acquire(size_t index)
+	{
+		uint8_t & stamp = m_stamp_list[index / BLOCK_SIZE];
+		if (stamp == m_epoch) {return false;}
+		stamp = m_epoch;
+		return true;
+	}
+
+	// Make every block stale
+	void advance(void)
+	{
+		m_epoch++;
+		if (m_epoch == 0)
+		{
+			std::memset(m_stamp_list, 0, BLOCK_COUNT);
+			m_epoch = 1;
+		}
+	}
+};
+
+
+
+
+// Eviction policies of ForgetfulHash
+// A policy keeps metadata for each of the CAPACITY value slots and is notified of every change:
+//   on_insert(index, hash): a new key is stored in value slot @index; @hash is the hashed position of the key
+//   on_hit(index): the key of value slot @index is accessed
+//   on_remove(index): the key of value slot @index is removed without being selected (e.g. expired); the slot may be inserted again later
+//   select_victim(): at least one slot is used; return one of the used slots
+//   on_restore(index): value slot @index, returned by the last select_victim(), is kept after all; it becomes the next victim again
+//     (several restored slots are restored in the reverse order of their selection)
+//   clear(): forget every slot, in constant (amortized) time
+// A positional policy (IS_POSITIONAL) selects the victim from the key table instead
+
+
+// Evict the key stored closest before the insertion position
+// This needs no metadata but is close to random eviction
+template <size_t CAPACITY>
+class EvictionNearest
+{
+public:
+	static constexpr bool const IS_POSITIONAL = true;
+
+	void on_insert(size_t, size_t) {}
+	void on_hit(size_t) {}
+	void on_remove(size_t) {}
+	void clear(void) {}
+};
+
+
+// Second chance: slots are scanned cyclically, and slots accessed since the last scan are spared once
+template <size_t CAPACITY>
+class EvictionClock
+{
+public:
+	static constexpr bool const IS_POSITIONAL = false;
+
+private:
+	static constexpr uint8_t const SLOT_REMOVED = 2;
+
+private:
+	uint8_t				m_referenced_list[CAPACITY];	// 0, 1 or SLOT_REMOVED
+	size_t				m_hand;
+	size_t				m_used;		// Slots are inserted in increasing order first; the hand only visits inserted slots
+
+public:
+	EvictionClock(void) noexcept : m_hand(0), m_used(0) {}
+
+	void on_insert(size_t index, size_t)
+	{
+		m_referenced_list[index] = 0;
+		if (index >= m_used) {m_used = index + 1;}
+	}
+
+	void on_hit(size_t index) {m_referenced_list[index] = 1;}
+
+	void on_remove(size_t index) {m_referenced_list[index] = SLOT_REMOVED;}
+
+	size_t select_victim(void)
+	{
+		while (m_referenced_list[m_hand] != 0)
+		{
+			if (m_referenced_list[m_hand] == 1) {m_referenced_list[m_hand] = 0;}
+			m_hand = (m_hand + 1 >= m_used) ? 0 : m_hand + 1;
+		}
+		size_t victim = m_hand;
+		m_referenced_list[victim] = SLOT_REMOVED;
+		m_hand = (m_hand + 1 >= m_used) ? 0 : m_hand + 1;
+		return victim;
+	}
+
+	void on_restore(size_t index)
+	{
+		m_referenced_list[index] = 0;
+		m_hand = index;
+	}
+
+	void clear(void)
+	{
+		m_hand = 0;
+		m_used = 0;
+	}
+};
+
+
+// Exact least recently used
+template <size_t CAPACITY>
+class EvictionLRU
+{
+public:
+	static constexpr bool const IS_POSITIONAL = false;
+
+private:
+	LinkedCycleUnsafe	m_link_list[CAPACITY];	// Links of unused slots are left dangling
+	LinkedCycle				m_anchor;		// Next is the most recently used slot
+
+public:
+	void on_insert(size_t index, size_t) {m_link_list[index].insert_single_as_next_of(m_anchor);}
+
+	void on_hit(size_t index)
+	{
+		m_link_list[index].remove_from_cycle();
+		m_link_list[index].insert_single_as_next_of(m_anchor);
+	}
+
+	void on_remove(size_t index) {m_link_list[index].remove_from_cycle();}
+
+	size_t select_victim(void)
+	{
+		LinkedCycleUnsafe & link = m_anchor.LinkedCycleUnsafe::prev();
+		link.remove_from_cycle();
+		return &link - m_link_list;
+	}
+
+	void on_restore(size_t index) {m_link_list[index].insert_single_as_prev_of(m_anchor);}
+
+	void clear(void) {m_anchor.become_safe();}
+};
+
+
+// S3-FIFO: new keys enter a small FIFO queue holding about 10% of the slots
+// Keys accessed more than once while in the small queue are promoted to the main FIFO queue, others are evicted and remembered in a ghost table
+// Keys of the ghost table enter the main queue directly
+// Keys in the main queue are reinserted while their access frequency (saturating at 3) is positive, decrementing it each time
+// The ghost table is direct-mapped on the hashed position, hence approximate; it is reset lazily by blocks
+template <size_t CAPACITY>
+class EvictionS3FIFO
+{
+public:
+	static constexpr bool const IS_POSITIONAL = false;
+
+private:
+	static constexpr size_t const SMALL_CAPACITY = (CAPACITY >= 10) ? CAPACITY / 10 : 1;
+	static constexpr uint8_t const FREQUENCY_MAX = 3;
+	static constexpr size_t const GHOST_INVALID = (size_t)(-1);
+	static constexpr size_t const GHOST_BLOCK_SIZE = 16;
+
+private:
+	LinkedCycleUnsafe	m_link_list[CAPACITY];	// Links of unused slots are left dangling
+	uint8_t						m_frequency_list[CAPACITY];
+	uint8_t						m_is_main_list[CAPACITY];
+	size_t						m_hash_list[CAPACITY];
+	size_t						m_ghost_list[CAPACITY];
+	HashEpochBlocks<CAPACITY, GHOST_BLOCK_SIZE>	m_ghost_blocks;
+	LinkedCycle				m_small_anchor;		// Prev is the oldest slot
+	LinkedCycle				m_main_anchor;
+	size_t						m_small_size;
+
+private:
+	size_t pop_oldest(LinkedCycle & anchor)
+	{
+		LinkedCycleUnsafe & link = anchor.LinkedCycleUnsafe::prev();
+		link.remove_from_cycle();
+		return &link - m_link_list;
+	}
+
+	size_t & get_ghost(size_t hash)
+	{
+		size_t index = hash % CAPACITY;
+		if (m_ghost_blocks.acquire(index))
+		{
+			for (size_t i = m_ghost_blocks.get_block_begin(index); i < m_ghost_blocks.get_block_end(index); i++)
+			{
+				m_ghost_list[i] = GHOST_INVALID;
+			}
+		}
+		return m_ghost_list[index];
+	}
+
+public:
+	EvictionS3FIFO(void) noexcept : m_small_size(0) {}
+
+	void on_insert(size_t index, size_t hash)
+	{
+		size_t & ghost = get_ghost(hash);
+		m_frequency_list[index] = 0;
+		m_hash_list[index] = hash;
+		if (ghost == hash)
+		{
+			ghost = GHOST_INVALID;
+			m_is_main_list[index] = 1;
+			m_link_list[index].insert_single_as_next_of(m_main_anchor);
+		}
+		else
+		{
+			m_is_main_list[index] = 0;
+			m_link_list[index].insert_single_as_next_of(m_small_anchor);
+			m_small_size++;
+		}
+	}
+
+	void on_hit(size_t index)
+	{
+		if (m_frequency_list[index] < FREQUENCY_MAX) {m_frequency_list[index]++;}
+	}
+
+	void on_remove(size_t index)
+	{
+		m_link_list[index].remove_from_cycle();
+		if (!m_is_main_list[index]) {m_small_size--;}
+	}
+
+	size_t select_victim(void)
+	{
+		while (1)
+		{
+			if (m_small_size >= SMALL_CAPACITY || m_main_anchor.is_single())
+			{
+				size_t index = pop_oldest(m_small_anchor);
+				m_small_size--;
+				if (m_frequency_list[index] > 1)
+				{
+					m_frequency_list[index] = 0;
+					m_is_main_list[index] = 1;
+					m_link_list[index].insert_single_as_next_of(m_main_anchor);
+				}
+				else
+				{
+					get_ghost(m_hash_list[index]) = m_hash_list[index];
+					return index;
+				}
+			}
+			else
+			{
+				size_t index = pop_oldest(m_main_anchor);
+				if (m_frequency_list[index] > 0)
+				{
+					m_frequency_list[index]--;
+					m_link_list[index].insert_single_as_next_of(m_main_anchor);
+				}
+				else
+				{
+					return index;
+				}
+			}
+		}
+	}
+
+	// The ghost entry recorded by the selection is dropped
+	void on_restore(size_t index)
+	{
+		if (m_is_main_list[index])
+		{
+			m_link_list[index].insert_single_as_prev_of(m_main_anchor);
+		}
+		else
+		{
+			size_t & ghost = get_ghost(m_hash_list[index]);
+			if (ghost == m_hash_list[index]) {ghost = GHOST_INVALID;}
+			m_link_list[index].insert_single_as_prev_of(m_small_anchor);
+			m_small_size++;
+		}
+	}
+
+	void clear(void)
+	{
+		m_small_anchor.become_safe();
+		m_main_anchor.become_safe();
+		m_ghost_blocks.advance();
+		m_small_size = 0;
+	}
+};
+
+
+
 
 // Open addressing hash table with conflict resolution by linear search
 // Once VALUE_CAPACITY has been reached, newly added key will replace existing key
-template <typename Key, typename Value, size_t KEY_CAPACITY, size_t VALUE_CAPACITY, size_t hash_func(Key)>
+// The replaced key is chosen by the @Eviction policy
+template <typename Key, typename Value, size_t KEY_CAPACITY, size_t VALUE_CAPACITY, size_t hash_func(Key), template <size_t> class Eviction = EvictionNearest>
 class ForgetfulHash
 {
+public:
+
+	// Time in any unit that wraps around, e.g. milliseconds since boot; an entry is expired once (now - expiry) >= 0
+	typedef uint32_t Time;
+	static constexpr Time const EXPIRY_NEVER = 0xFFFFFFFF;
 
 private:
 
 	static constexpr size_t const REF_INVALID = (size_t)(-1);  // 0xFF...FF
+	static constexpr size_t const FIND_BATCH_SIZE = 16;	// Keys prefetched ahead by find_batch()
+	static constexpr size_t const EPOCH_BLOCK_SIZE = 16;
+	static constexpr size_t const EVICT_CANDIDATE_MAX = 8;	// Candidates compared by evict()
 
 private:
 
@@ -32,6 +458,17 @@ private:
 	size_t			ref_list[KEY_CAPACITY];
 	Key					key_list[KEY_CAPACITY];
 	Value				value_array[VALUE_CAPACITY];
+	size_t			back_ref_list[VALUE_CAPACITY];	// Index in key_list of the key of each value; next free slot for free slots
+	Time				expiry_list[VALUE_CAPACITY];		// EXPIRY_NEVER for free slots
+	size_t			ref_count;	// Value slots handed out since the last clear; those in use or in the free list
+	size_t			free_ref;		// First free value slot below ref_count, chained through back_ref_list
+	size_t			sweep_ref;	// Next value slot examined by sweep()
+	Eviction<VALUE_CAPACITY>		eviction;
+	HashEpochBlocks<KEY_CAPACITY, EPOCH_BLOCK_SIZE>		epoch_blocks;	// ref_list is reset lazily by blocks
+
+	size_t			hit_count;
+	size_t			miss_count;
+	size_t			value_budget;	// Number of values kept, at most VALUE_CAPACITY
 
 
 private:
@@ -49,78 +486,117 @@ private:
 		return index - 1;
 	}
 
-	bool index_is_free(size_t index) const
+	bool index_is_free(size_t index)
 	{
+		if (epoch_blocks.acquire(index))
+		{
+			size_t begin = epoch_blocks.get_block_begin(index);
+			std::memset(ref_list + begin, 0xFF, (epoch_blocks.get_block_end(index) - begin) * sizeof(size_t));
+		}
 		return ref_list[index] == REF_INVALID;
 	}
 
-
-public:
-	ForgetfulHash(void) : size(0)
-	{
-		TX_ASSERT(KEY_CAPACITY > VALUE_CAPACITY && VALUE_CAPACITY > 0);
-		std::memset(ref_list, 0xFF, KEY_CAPACITY * sizeof(size_t));
-	}
-
-	size_t get_size(void) const {return size;}
-	size_t get_key_capacity(void) const {return KEY_CAPACITY;}
-	size_t get_value_capacity(void) const {return VALUE_CAPACITY;}
-
-	void clear(void)
+	size_t compute_distance(size_t index) const
 	{
-		size = 0;
-		std::memset(ref_list, 0xFF, KEY_CAPACITY * sizeof(size_t));
+		size_t index_opt = hash_func(key_list[index]);
+		return (index >= index_opt) ? index - index_opt : index + KEY_CAPACITY - index_opt;
 	}
 
-	Value * find(Key const & key)
+	Value * find_from(Key const & key, size_t index)
+	// @index is the hashed position of @key
 	{
-		size_t index = hash_func(key);
 		TX_ASSERT(index < KEY_CAPACITY);
 
 		while (!index_is_free(index))
 		{
-			if (key_list[index] == key) {return &value_array[ref_list[index]];}
+			if (key_list[index] == key)
+			{
+				hit_count++;
+				eviction.on_hit(ref_list[index]);
+				return &value_array[ref_list[index]];
+			}
 			index = next_index(index);
 		}
+		miss_count++;
 		return nullptr;
 	}
 
-	// This will move the key closer to its hashed position to speed up future search
-	Value * find_and_prioritize(Key const & key)
+	void remove_index(size_t index_remove)
+	// Remove the key at @index_remove; its value slot is left to the caller
 	{
-		size_t index = hash_func(key);
-		TX_ASSERT(index < KEY_CAPACITY);
-
-		if (!index_is_free(index) && key_list[index] == key)
+		// Shift table up
+		size_t distance = 1;
+		size_t index_replace = next_index(index_remove);
+		while (!index_is_free(index_replace))
 		{
-			return &value_array[ref_list[index]];
+			if (compute_distance(index_replace) >= distance)
+			{
+				key_list[index_remove] = key_list[index_replace];
+				ref_list[index_remove] = ref_list[index_replace];
+				back_ref_list[ref_list[index_remove]] = index_remove;
+				distance = 0;
+				index_remove = index_replace;
+			}
+			distance ++;
+			index_replace = next_index(index_replace);
 		}
+		ref_list[index_remove] = REF_INVALID;
+	}
 
-		size_t index_next = next_index(index);
-		while (!index_is_free(index))
-		{
-			if (key_list[index_next] == key)
-			{
-				Key temp_key = key_list[index_next];
-				key_list[index_next] = key_list[index];
-				key_list[index] = temp_key;
+	static bool is_expired(Time expiry, Time now) {return expiry != EXPIRY_NEVER && (int32_t)(now - expiry) >= 0;}
 
-				size_t temp_num = ref_list[index_next];
-				ref_list[index_next] = ref_list[index];
-				ref_list[index] = temp_num;
+	void release_entry(size_t index)
+	// Remove the key at @index and release its value slot; the eviction policy must no longer track the slot
+	{
+		size_t ref = ref_list[index];
+		remove_index(index);
+		expiry_list[ref] = EXPIRY_NEVER;
+		back_ref_list[ref] = free_ref;
+		free_ref = ref;
+		size--;
+	}
 
-				return &value_array[temp_num];
-			}
+	void remove_entry(size_t index)
+	{
+		eviction.on_remove(ref_list[index]);
+		release_entry(index);
+	}
 
-			index = index_next;
-			index_next = next_index(index);
-		}
+	Value * check_expiry(Value * value, Time now)
+	// Remove the entry of @value if it is expired, turning the hit into a miss
+	{
+		if (value == nullptr) {return nullptr;}
+
+		size_t ref = value - value_array;
+		if (!is_expired(expiry_list[ref], now)) {return value;}
+		remove_entry(back_ref_list[ref]);
+		hit_count--;
+		miss_count++;
 		return nullptr;
 	}
 
-	// Replace current value if it exists
-	// Remove another existing key if storage is insufficient
-	void insert(Key const & key, Value const & value)
+	void find_batch(Key const * key_in, size_t count, Value ** value_out, Time now, bool is_checking_expiry)
+	{
+		size_t index_list[FIND_BATCH_SIZE];
+		for (size_t begin = 0; begin < count; begin += FIND_BATCH_SIZE)
+		{
+			size_t batch_size = (count - begin < FIND_BATCH_SIZE) ? count - begin : FIND_BATCH_SIZE;
+			for (size_t i = 0; i < batch_size; i++)
+			{
+				index_list[i] = hash_func(key_in[begin + i]);
+				__builtin_prefetch(&ref_list[index_list[i]]);
+				__builtin_prefetch(&key_list[index_list[i]]);
+			}
+			for (size_t i = 0; i < batch_size; i++)
+			{
+				Value * value = find_from(key_in[begin + i], index_list[i]);
+				value_out[begin + i] = is_checking_expiry ? check_expiry(value, now) : value;
+			}
+		}
+	}
+
+	void insert_entry(Key const & key, Value const & value, Time expiry)
+	// Replace current value if it exists; @expiry is stored as is
 	{
 		size_t key_index = hash_func(key);
 		TX_ASSERT(key_index < KEY_CAPACITY);
@@ -131,6 +607,8 @@ public:
 			if (key_list[index] == key)
 			{
 				value_array[ref_list[index]] = value;
+				expiry_list[ref_list[index]] = expiry;
+				eviction.on_hit(ref_list[index]);
 				return;
 			}
 			index = next_index(index);
@@ -140,11 +618,33 @@ public:
 		// key_list[index] is now a legal location to store the key
 
 		// Find a position in value_array to store the new value
-		if (size < VALUE_CAPACITY)
+		if (free_ref != REF_INVALID)
 		{
-			ref_list[index] = size;
+			ref_list[index] = free_ref;
+			free_ref = back_ref_list[free_ref];
 			size ++;
 		}
+		else if (ref_count < value_budget)
+		{
+			ref_list[index] = ref_count;
+			ref_count ++;
+			size ++;
+		}
+		else if constexpr (!Eviction<VALUE_CAPACITY>::IS_POSITIONAL)
+		{
+			// Reaching here means that value_array is full
+			// Remove the key chosen by the eviction policy and reuse its value slot
+			size_t ref = eviction.select_victim();
+			remove_index(back_ref_list[ref]);
+
+			// The removal may have shifted the cluster of the new key
+			index = key_index;
+			while (!index_is_free(index))
+			{
+				index = next_index(index);
+			}
+			ref_list[index] = ref;
+		}
 		else
 		{
 			// Reaching here means that value_array is full
@@ -169,33 +669,258 @@ public:
 				ref_list[index] = ref_list[index_remove];
 				ref_list[index_remove] = REF_INVALID;
 			}
-		}
+		}
+
+		// Store the new key-value pair
+		key_list[index] = key;
+		value_array[ref_list[index]] = value;
+		expiry_list[ref_list[index]] = expiry;
+		back_ref_list[ref_list[index]] = index;
+		eviction.on_insert(ref_list[index], key_index);
+	}
+
+
+public:
+	ForgetfulHash(void) : size(0), ref_count(0), free_ref(REF_INVALID), sweep_ref(0), hit_count(0), miss_count(0), value_budget(VALUE_CAPACITY)
+	{
+		TX_ASSERT(KEY_CAPACITY > VALUE_CAPACITY && VALUE_CAPACITY > 0);
+	}
+
+	size_t get_size(void) const {return size;}
+	size_t get_key_capacity(void) const {return KEY_CAPACITY;}
+	size_t get_value_capacity(void) const {return VALUE_CAPACITY;}
+	size_t get_value_budget(void) const {return value_budget;}
+
+	// Limit the number of values kept to @budget; keys are replaced once it is reached
+	// A table already holding more values keeps them until clear()
+	void set_value_budget(size_t budget)
+	{
+		TX_ASSERT(budget > 0 && budget <= VALUE_CAPACITY);
+		value_budget = budget;
+	}
+
+	// Lookup statistics of find() and find_and_prioritize()
+	size_t get_hit_count(void) const {return hit_count;}
+	size_t get_miss_count(void) const {return miss_count;}
+	void reset_statistics(void) {hit_count = 0; miss_count = 0;}
+
+	// Constant time; slots are reset lazily
+	void clear(void)
+	{
+		size = 0;
+		ref_count = 0;
+		free_ref = REF_INVALID;
+		sweep_ref = 0;
+		epoch_blocks.advance();
+		eviction.clear();
+	}
+
+	// Expiry is not checked
+	Value * find(Key const & key) {return find_from(key, hash_func(key));}
+
+	// An expired entry is removed and reported as missing
+	Value * find(Key const & key, Time now) {return check_expiry(find(key), now);}
+
+	// Remove the key if it exists, and copy its value to @value
+	bool remove(Key const & key, Value & value)
+	{
+		size_t index = hash_func(key);
+		TX_ASSERT(index < KEY_CAPACITY);
+
+		while (!index_is_free(index))
+		{
+			if (key_list[index] == key)
+			{
+				value = value_array[ref_list[index]];
+				remove_entry(index);
+				return true;
+			}
+			index = next_index(index);
+		}
+		return false;
+	}
+
+	bool remove(Key const & key)
+	{
+		Value value;
+		return remove(key, value);
+	}
+
+	// Remove the entry chosen by the eviction policy, and copy its value to @value
+	// Return false if the table is empty
+	bool evict(Value & value)
+	{
+		static_assert(!Eviction<VALUE_CAPACITY>::IS_POSITIONAL);
+		if (size == 0) {return false;}
+
+		size_t ref = eviction.select_victim();
+		value = value_array[ref];
+		release_entry(back_ref_list[ref]);
+		return true;
+	}
+
+	// Remove one of the next @candidate_count entries in the order of the eviction policy, and copy its value to @value
+	// @is_better_victim(a, b) returns true if the entry of value @a should rather be removed than the entry of value @b;
+	// otherwise the earliest candidate is removed. The other candidates keep their place in the eviction order
+	// Return false if the table is empty
+	template <typename Compare>
+	bool evict(Value & value, size_t candidate_count, Compare is_better_victim)
+	{
+		static_assert(!Eviction<VALUE_CAPACITY>::IS_POSITIONAL);
+		TX_ASSERT(candidate_count > 0 && candidate_count <= EVICT_CANDIDATE_MAX);
+		if (size == 0) {return false;}
+		if (candidate_count > size) {candidate_count = size;}
+
+		size_t candidate_list[EVICT_CANDIDATE_MAX];
+		size_t victim = 0;
+		for (size_t i = 0; i < candidate_count; i++)
+		{
+			candidate_list[i] = eviction.select_victim();
+			if (is_better_victim(value_array[candidate_list[i]], value_array[candidate_list[victim]])) {victim = i;}
+		}
+		for (size_t i = candidate_count; i-- > 0;)
+		{
+			if (i != victim) {eviction.on_restore(candidate_list[i]);}
+		}
+
+		size_t ref = candidate_list[victim];
+		value = value_array[ref];
+		release_entry(back_ref_list[ref]);
+		return true;
+	}
+
+	// Examine up to @budget value slots, resuming where the previous call stopped, and remove the expired entries
+	// Return the number of entries removed
+	size_t sweep(Time now, size_t budget)
+	{
+		size_t removed = 0;
+		for (; budget > 0 && ref_count > 0; budget--)
+		{
+			if (sweep_ref >= ref_count) {sweep_ref = 0;}
+			if (is_expired(expiry_list[sweep_ref], now))
+			{
+				remove_entry(back_ref_list[sweep_ref]);
+				removed++;
+			}
+			sweep_ref++;
+		}
+		return removed;
+	}
+
+	// Look up @count keys at once; @value_out[i] is set as find(@key_in[i]) would return, hence expiry is not checked
+	// The hashed positions of a batch are computed and prefetched before any probing, so that the cache misses overlap
+	void find_batch(Key const * key_in, size_t count, Value ** value_out) {find_batch(key_in, count, value_out, EXPIRY_NEVER, false);}
+
+	// Same with expiry checked as by find(@key_in[i], @now)
+	void find_batch(Key const * key_in, size_t count, Value ** value_out, Time now) {find_batch(key_in, count, value_out, now, true);}
+
+	// This will move the key closer to its hashed position to speed up future search
+	// Expiry is not checked
+	Value * find_and_prioritize(Key const & key)
+	{
+		size_t index = hash_func(key);
+		TX_ASSERT(index < KEY_CAPACITY);
+
+		if (!index_is_free(index) && key_list[index] == key)
+		{
+			hit_count++;
+			eviction.on_hit(ref_list[index]);
+			return &value_array[ref_list[index]];
+		}
+
+		size_t index_next = next_index(index);
+		while (!index_is_free(index) && !index_is_free(index_next))
+		{
+			if (key_list[index_next] == key)
+			{
+				Key temp_key = key_list[index_next];
+				key_list[index_next] = key_list[index];
+				key_list[index] = temp_key;
+
+				size_t temp_num = ref_list[index_next];
+				ref_list[index_next] = ref_list[index];
+				ref_list[index] = temp_num;
+
+				back_ref_list[ref_list[index_next]] = index_next;
+				back_ref_list[temp_num] = index;
+
+				hit_count++;
+				eviction.on_hit(temp_num);
+				return &value_array[temp_num];
+			}
 
-		// Store the new key-value pair
-		key_list[index] = key;
-		value_array[ref_list[index]] = value;
+			index = index_next;
+			index_next = next_index(index);
+		}
+		miss_count++;
+		return nullptr;
 	}
 
+	// An expired entry is removed and reported as missing, as by find(@key, @now)
+	Value * find_and_prioritize(Key const & key, Time now) {return check_expiry(find_and_prioritize(key), now);}
+
+	// Replace current value if it exists
+	// Remove another existing key if storage is insufficient
+	void insert(Key const & key, Value const & value) {insert_entry(key, value, EXPIRY_NEVER);}
+
+	// The entry expires at @expiry
+	// An expiry that falls on the reserved value EXPIRY_NEVER (e.g. after the time wraps around) is moved one tick earlier
+	void insert(Key const & key, Value const & value, Time expiry) {insert_entry(key, value, (expiry == EXPIRY_NEVER) ? EXPIRY_NEVER - 1 : expiry);}
+
 
 };
 
 
-template <typename Key, typename Value, size_t CAPACITY, Key const & KEY_INVALID, size_t hash_func(Key)>
+// Default tag_func of HashTable: 7 bits of a hash of the key that the hashed position does not determine,
+// so that the control bytes also separate the keys that collide on the same position
+// Integers, enumerations and pointers are hashed again by hash_value(); the tag of other types, whose equality may not be bitwise,
+// falls back to the hashed position @index_opt, and a dedicated tag_func should be given (e.g. string_key_tag for StringKey)
+template <typename Key>
+uint8_t hash_tag(Key const & key, size_t index_opt)
+{
+	if constexpr (std::is_integral<Key>::value || std::is_enum<Key>::value || std::is_pointer<Key>::value)
+	{
+		return (uint8_t)(hash_value(key) & 0x7Fu);
+	}
+	else
+	{
+		return (uint8_t)(index_opt & 0x7Fu);
+	}
+}
+
+
+template <typename Key, typename Value, size_t CAPACITY, Key const & KEY_INVALID, size_t hash_func(Key), uint8_t tag_func(Key const &, size_t)>
+class HashImage;
+
+// @tag_func returns the 7-bit tag of a key stored in the control bytes, given the key and its hashed position
+// Lookups do not write to the table, so that any number of threads may look up keys while no thread modifies it
+template <typename Key, typename Value, size_t CAPACITY, Key const & KEY_INVALID, size_t hash_func(Key), uint8_t tag_func(Key const &, size_t) = hash_tag<Key>>
 class HashTable
 {
+	friend class HashImage<Key, Value, CAPACITY, KEY_INVALID, hash_func, tag_func>;
 
 private:
 
 	static constexpr size_t const INDEX_INVALID = 0xFFFFFFFF;
+	static constexpr size_t const CONTROL_SIZE = CAPACITY + HashControlGroup::SIZE - 1;
+	static constexpr size_t const FIND_BATCH_SIZE = 16;	// Keys prefetched ahead by find_batch()
+	static constexpr size_t const EPOCH_BLOCK_SIZE = HashControlGroup::SIZE;
 
 private:
 
 	size_t			size;
+	size_t			distance_sum;	// Sum of the distances of all keys from their hashed positions
+	size_t			distance_max;	// Largest distance since the last clear; upper bound of the current largest distance
+	uint8_t			control_list[CONTROL_SIZE]; // Tag of the key in each slot, or HashControlGroup::EMPTY
+	HashEpochBlocks<CAPACITY, EPOCH_BLOCK_SIZE>		epoch_blocks;	// control_list is reset lazily by blocks, when a key is stored in the block
 	Key					key_list[CAPACITY];
 	Value				value_list[CAPACITY];
 
 	// Assumptions on data:
-	//   key_list is not full (at least one key is KEY_INVALID)
+	//   key_list is not full (at least one slot is empty)
+	//   control_list[CAPACITY + i] mirrors control_list[i] so that groups can be loaded across the end of the table
+	//   control bytes are only valid in blocks acquired in the current epoch; other blocks read as empty, and refresh() must precede a write
+	//   Robin Hood ordering: along a cluster, a key is never further from its hashed position than the key after it plus one
 
 
 private:
@@ -213,83 +938,216 @@ private:
 		return index - 1;
 	}
 
+	static size_t wrap_index(size_t index)
+	{
+		while (index >= CAPACITY) {index -= CAPACITY;}
+		return index;
+	}
+
 	size_t compute_distance(size_t index) const
 	{
 		size_t index_opt = hash_func(key_list[index]);
-		return (index >= index_opt) ? index - index_opt : index_opt + CAPACITY - index;
+		return (index >= index_opt) ? index - index_opt : index + CAPACITY - index_opt;
 	}
 
+	static uint8_t compute_tag(Key const & key, size_t index_opt)
+	{
+		uint8_t tag = tag_func(key, index_opt);
+		TX_ASSERT(tag < HashControlGroup::EMPTY);
+		return tag;
+	}
 
-public:
-	HashTable(void) : size(0)
+	void refresh(size_t index)
 	{
-		TX_ASSERT(CAPACITY > 0);
-		for (size_t i = 0; i < CAPACITY; i++)
+		if (!epoch_blocks.acquire(index)) {return;}
+		size_t begin = epoch_blocks.get_block_begin(index);
+		size_t count = epoch_blocks.get_block_end(index) - begin;
+		for (size_t i = begin; i < CONTROL_SIZE; i += CAPACITY)
+		{
+			std::memset(control_list + i, HashControlGroup::EMPTY, (count < CONTROL_SIZE - i) ? count : CONTROL_SIZE - i);
+		}
+	}
+
+	HashControlGroup load_group(size_t index) const
+	// Load the group at @index without writing to the table: the bytes of stale blocks are replaced by empty ones in a copy
+	// The last block is shorter if CAPACITY is not a multiple of the group size, so that a group may cover more than two blocks
+	{
+		uint8_t control_copy[HashControlGroup::SIZE];
+		bool is_copied = false;
+		size_t end = index + HashControlGroup::SIZE;
+		for (size_t i = index; i < end;)
+		{
+			size_t index_wrapped = wrap_index(i);
+			size_t block_end = i + (epoch_blocks.get_block_end(index_wrapped) - index_wrapped);
+			if (block_end > end) {block_end = end;}
+			if (!epoch_blocks.is_current(index_wrapped))
+			{
+				if (!is_copied)
+				{
+					std::memcpy(control_copy, control_list + index, HashControlGroup::SIZE);
+					is_copied = true;
+				}
+				std::memset(control_copy + (i - index), HashControlGroup::EMPTY, block_end - i);
+			}
+			i = block_end;
+		}
+		return HashControlGroup(is_copied ? control_copy : control_list + index);
+	}
+
+	bool index_is_free(size_t index) const
+	{
+		return !epoch_blocks.is_current(index) || control_list[index] == HashControlGroup::EMPTY;
+	}
+
+	void set_control(size_t index, uint8_t control)
+	{
+		for (size_t i = index; i < CONTROL_SIZE; i += CAPACITY)
 		{
-			key_list[i] = KEY_INVALID;
+			control_list[i] = control;
 		}
 	}
 
+	void record_distance(size_t distance)
+	{
+		distance_sum += distance;
+		if (distance > distance_max) {distance_max = distance;}
+	}
+
+
+public:
+	HashTable(void) : size(0), distance_sum(0), distance_max(0)
+	{
+		TX_ASSERT(CAPACITY > 0);
+	}
+
 	size_t get_size(void) const {return size;}
 	size_t get_capacity(void) const {return CAPACITY;}
 
-	size_t find_index(Key const & key) const
+	// Number of slots examined by a successful lookup
+	size_t get_max_probe_length(void) const {return distance_max + 1;}
+	float get_mean_probe_length(void) const {return (size == 0) ? 0.0f : 1.0f + (float) distance_sum / (float) size;}
+
+	size_t find_index(Key const & key) const {return find_index_from(key, hash_func(key));}
+
+	size_t find_index_from(Key const & key, size_t index) const
+	// @index is the hashed position of @key
 	{
-		size_t index = hash_func(key);
 		TX_ASSERT(index < CAPACITY);
+		uint8_t tag = compute_tag(key, index);
 
-		while (key_list[index] != key)
+		// Probe group by group; keys are only compared at slots with a matching tag
+		// The search stops early once it is further from the hashed position than any key has ever been placed
+		size_t distance = 0;
+		while (1)
 		{
-			if (key_list[index] == KEY_INVALID) {return INDEX_INVALID;}
-			index = next_index(index);
+			HashControlGroup group = load_group(index);
+			HashControlGroup::Mask empty = group.match_empty();
+			HashControlGroup::Mask match = group.match(tag) & HashControlGroup::slots_before(empty);
+			while (match != 0)
+			{
+				size_t index_match = wrap_index(index + HashControlGroup::lowest_slot(match));
+				if (key_list[index_match] == key) {return index_match;}
+				match = HashControlGroup::remove_lowest_slot(match);
+			}
+			if (empty != 0) {return INDEX_INVALID;}
+			distance += HashControlGroup::SIZE;
+			if (distance > distance_max) {return INDEX_INVALID;}
+			index = wrap_index(index + HashControlGroup::SIZE);
 		}
-
-		return index;
 	}
 
 	Value * find(Key const & key)
 	{
-		size_t index = hash_func(key);
-		TX_ASSERT(index < CAPACITY);
+		size_t index = find_index(key);
+		return (index == INDEX_INVALID) ? nullptr : &value_list[index];
+	}
+
+	Value const * find(Key const & key) const
+	{
+		size_t index = find_index(key);
+		return (index == INDEX_INVALID) ? nullptr : &value_list[index];
+	}
 
-		while (key_list[index] != key)
+	// Look up @count keys at once; @value_out[i] is set as find(@key_in[i]) would return
+	// The hashed positions of a batch are computed and prefetched before any probing, so that the cache misses overlap
+	void find_batch(Key const * key_in, size_t count, Value ** value_out)
+	{
+		size_t index_list[FIND_BATCH_SIZE];
+		for (size_t begin = 0; begin < count; begin += FIND_BATCH_SIZE)
 		{
-			if (key_list[index] == KEY_INVALID) {return nullptr;}
-			index = next_index(index);
+			size_t batch_size = (count - begin < FIND_BATCH_SIZE) ? count - begin : FIND_BATCH_SIZE;
+			for (size_t i = 0; i < batch_size; i++)
+			{
+				index_list[i] = hash_func(key_in[begin + i]);
+				__builtin_prefetch(&control_list[index_list[i]]);
+				__builtin_prefetch(&key_list[index_list[i]]);
+			}
+			for (size_t i = 0; i < batch_size; i++)
+			{
+				size_t index = find_index_from(key_in[begin + i], index_list[i]);
+				value_out[begin + i] = (index == INDEX_INVALID) ? nullptr : &value_list[index];
+			}
 		}
-		return &value_list[index];
 	}
 
+	// Constant time; slots are reset lazily
 	void clear(void)
 	{
 		size = 0;
-		for (size_t i = 0; i < CAPACITY; i++)
-		{
-			key_list[i] = KEY_INVALID;
-		}
+		distance_sum = 0;
+		distance_max = 0;
+		epoch_blocks.advance();
 	}
 
 	// Replace current value if it exists
+	// A new key takes the slot of the first key that is closer to its hashed position (Robin Hood hashing);
+	// the displaced key continues the search for a slot
 	void insert(Key const & key, Value const & value)
 	{
 		TX_ASSERT(key != KEY_INVALID);
 
-		size_t index = hash_func(key);
-		TX_ASSERT(index < CAPACITY);
-
-		while (key_list[index] != KEY_INVALID && key_list[index] != key)
+		size_t index = find_index(key);
+		if (index != INDEX_INVALID)
 		{
-			index = next_index(index);
+			value_list[index] = value;
+			return;
 		}
 
-		if (key_list[index] != key)
+		size++;
+		TX_ASSERT(size < CAPACITY); // Ensure that key_list is not full
+
+		index = hash_func(key);
+		TX_ASSERT(index < CAPACITY);
+
+		uint8_t carried_control = compute_tag(key, index);
+		Key carried_key = key;
+		Value carried_value = value;
+		size_t distance = 0;
+
+		while (!index_is_free(index))
 		{
-			key_list[index] = key;
-			size++;
+			size_t distance_resident = compute_distance(index);
+			if (distance_resident < distance)
+			{
+				uint8_t temp_control = control_list[index];
+				set_control(index, carried_control);
+				carried_control = temp_control;
+				std::swap(key_list[index], carried_key);
+				std::swap(value_list[index], carried_value);
+
+				record_distance(distance);
+				distance_sum -= distance_resident;
+				distance = distance_resident;
+			}
+			distance ++;
+			index = next_index(index);
 		}
-		value_list[index] = value;
 
-		TX_ASSERT(size < CAPACITY); // Ensure that key_list is not full
+		refresh(index);
+		set_control(index, carried_control);
+		key_list[index] = std::move(carried_key);
+		value_list[index] = std::move(carried_value);
+		record_distance(distance);
 	}
 
 	// Insert without growing the size of the table
@@ -330,35 +1188,373 @@ public:
 	{
 		TX_ASSERT(key != KEY_INVALID);
 
-		size_t index_remove = hash_func(key);
-		TX_ASSERT(index_remove < CAPACITY);
+		size_t index_remove = find_index(key);
+		if (index_remove == INDEX_INVALID) {return;}
+
+		distance_sum -= compute_distance(index_remove);
+
+		// Shift table up
+		// Thanks to the Robin Hood ordering, the shift stops at the first key that is at its hashed position
+		size_t index_replace = next_index(index_remove);
+		while (!index_is_free(index_replace) && compute_distance(index_replace) > 0)
+		{
+			distance_sum -= 1;
+			set_control(index_remove, control_list[index_replace]);
+			key_list[index_remove] = key_list[index_replace];
+			value_list[index_remove] = value_list[index_replace];
+			index_remove = index_replace;
+			index_replace = next_index(index_replace);
+		}
+
+		set_control(index_remove, HashControlGroup::EMPTY);
+		size --;
+	}
+
+
+};
+
+
+// Resizable open addressing hash table with conflict resolution by linear search
+// @hash_func may return any value; it is reduced to the current capacity (a power of two) by masking
+// Once the load exceeds @max_load_percent, the capacity is doubled and the entries are migrated incrementally:
+// every insertion and removal moves a few entries from the old table to the new one, so that no single operation rehashes the whole table
+// The keys of a new table are constructed lazily by blocks of slots, when a key is first stored in the block; until then the block reads as empty,
+// so that allocating a table only clears one bit per block
+// Pointers returned by find() are invalidated by insertion and removal
+template <typename Key, typename Value, Key const & KEY_INVALID, size_t hash_func(Key)>
+class DynamicHashTable
+{
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+private:
+
+	static constexpr size_t const INDEX_INVALID = (size_t)(-1);
+	static constexpr size_t const BLOCK_SIZE_LOG2 = 4;
+
+	struct Table
+	{
+		Key *				key_list;		// nullptr if the table is not allocated; only the keys of ready blocks are constructed
+		Value *			value_list;	// Only the entries with a valid key are constructed
+		uint32_t *	ready_list;	// Bit set for each block whose keys are constructed
+		size_t			mask;				// Capacity - 1
+		size_t			size;
+	};
+
+private:
+
+	Table					m_table;
+	Table					m_old_table;				// Table being migrated into m_table; not allocated if no migration is in progress
+	size_t				m_migration_index;	// Entries of m_old_table before this index have been migrated
+	size_t				m_migration_step;		// Number of slots of m_old_table processed per operation
+
+	size_t				m_max_load_percent;
+	size_t				m_max_size;					// Size of m_table that triggers growth
+
+	Alloc					m_alloc;
+	Free					m_free;
+
+private:
+
+	static size_t get_block_count(Table const & table) {return ((table.mask + 1) + (1u << BLOCK_SIZE_LOG2) - 1) >> BLOCK_SIZE_LOG2;}
+
+	static bool is_ready(Table const & table, size_t index)
+	{
+		size_t block = index >> BLOCK_SIZE_LOG2;
+		return (table.ready_list[block / 32] >> (block % 32)) & 1u;
+	}
+
+	static bool is_free(Table const & table, size_t index) {return !is_ready(table, index) || table.key_list[index] == KEY_INVALID;}
+
+	static size_t get_block_end(Table const & table, size_t block)
+	{
+		size_t end = (block + 1) << BLOCK_SIZE_LOG2;
+		return (end < table.mask + 1) ? end : table.mask + 1;
+	}
+
+	static void make_ready(Table & table, size_t index)
+	{
+		if (is_ready(table, index)) {return;}
+		size_t block = index >> BLOCK_SIZE_LOG2;
+		for (size_t i = block << BLOCK_SIZE_LOG2; i < get_block_end(table, block); i++)
+		{
+			::new(table.key_list + i) Key(KEY_INVALID);
+		}
+		table.ready_list[block / 32] |= (uint32_t) 1 << (block % 32);
+	}
+
+	static void release_block(Table & table, size_t block)
+	// Destroy the keys of @block, which must hold no entry; the block reads as empty again
+	{
+		if (!is_ready(table, block << BLOCK_SIZE_LOG2)) {return;}
+		if (!std::is_trivially_destructible<Key>::value)
+		{
+			for (size_t i = block << BLOCK_SIZE_LOG2; i < get_block_end(table, block); i++)
+			{
+				table.key_list[i].~Key();
+			}
+		}
+		table.ready_list[block / 32] &= ~((uint32_t) 1 << (block % 32));
+	}
+
+	static size_t compute_distance(Table const & table, size_t index)
+	{
+		return (index - hash_func(table.key_list[index])) & table.mask;
+	}
+
+	size_t compute_max_size(Table const & table) const
+	{
+		// At least one key, and the table is never full since the capacity is at least 2
+		size_t max_size = (table.mask + 1) * m_max_load_percent / 100;
+		return (max_size > 0) ? max_size : 1;
+	}
+
+	void allocate_table(Table & table, size_t capacity_log2)
+	{
+		size_t capacity = (size_t) 1 << capacity_log2;
+		table.key_list = (Key *) m_alloc(capacity * sizeof(Key));
+		table.value_list = (Value *) m_alloc(capacity * sizeof(Value));
+		table.mask = capacity - 1;
+		table.size = 0;
+		size_t ready_size = (get_block_count(table) + 31) / 32 * sizeof(uint32_t);
+		table.ready_list = (uint32_t *) m_alloc(ready_size);
+		std::memset(table.ready_list, 0, ready_size);
+	}
+
+	void clear_table(Table & table)
+	{
+		for (size_t i = 0; i <= table.mask; i++)
+		{
+			if (!is_free(table, i))
+			{
+				table.value_list[i].~Value();
+				table.key_list[i] = KEY_INVALID;
+			}
+		}
+		table.size = 0;
+	}
+
+	void free_table(Table & table)
+	{
+		if (table.size > 0) {clear_table(table);}
+		if (!std::is_trivially_destructible<Key>::value)
+		{
+			for (size_t block = 0; block < get_block_count(table); block++)
+			{
+				release_block(table, block);
+			}
+		}
+		free_arrays(table);
+	}
+
+	void free_arrays(Table & table)
+	// Free the storage of @table, whose keys must all be released
+	{
+		m_free(table.key_list);
+		m_free(table.value_list);
+		m_free(table.ready_list);
+		table.key_list = nullptr;
+	}
+
+	static size_t find_index(Table const & table, Key const & key)
+	{
+		size_t index = hash_func(key) & table.mask;
+		while (1)
+		{
+			if (is_free(table, index)) {return INDEX_INVALID;}
+			if (table.key_list[index] == key) {return index;}
+			index = (index + 1) & table.mask;
+		}
+	}
 
-		while (key_list[index_remove] != key)
+	template <typename... Args>
+	static Value * insert_new(Table & table, Key const & key, Args && ... args)
+	// @key must not be in the table
+	{
+		size_t index = hash_func(key) & table.mask;
+		while (!is_free(table, index))
 		{
-			if (key_list[index_remove] == KEY_INVALID) {return;}
-			index_remove = next_index(index_remove);
+			index = (index + 1) & table.mask;
 		}
+		make_ready(table, index);
+		table.key_list[index] = key;
+		table.size++;
+		TX_ASSERT(table.size <= table.mask); // Ensure that key_list is not full
+		return ::new(table.value_list + index) Value(std::forward<Args>(args) ...);
+	}
+
+	static void remove_index(Table & table, size_t index_remove)
+	{
+		table.value_list[index_remove].~Value();
 
 		// Shift table up
 		size_t distance = 1;
-		size_t index_replace = next_index(index_remove);
-		while (key_list[index_replace] != KEY_INVALID)
+		size_t index_replace = (index_remove + 1) & table.mask;
+		while (!is_free(table, index_replace))
 		{
-			if (compute_distance(index_replace) >= distance)
+			if (compute_distance(table, index_replace) >= distance)
 			{
-				key_list[index_remove] = key_list[index_replace];
-				value_list[index_remove] = value_list[index_replace];
+				table.key_list[index_remove] = table.key_list[index_replace];
+				::new(table.value_list + index_remove) Value(std::move(table.value_list[index_replace]));
+				table.value_list[index_replace].~Value();
 				distance = 0;
 				index_remove = index_replace;
 			}
 			distance ++;
-			index_replace = next_index(index_replace);
+			index_replace = (index_replace + 1) & table.mask;
 		}
 
-		key_list[index_remove] = KEY_INVALID;
-		size --;
+		table.key_list[index_remove] = KEY_INVALID;
+		table.size --;
+	}
+
+	bool is_migrating(void) const {return m_old_table.key_list != nullptr;}
+
+	void migrate(size_t step_count)
+	// Process at most @step_count slots of the old table
+	{
+		for (size_t i = 0; i < step_count && is_migrating(); i++)
+		{
+			if (m_migration_index > m_old_table.mask)
+			{
+				// Every block has been released on the way
+				free_arrays(m_old_table);
+			}
+			else if (is_free(m_old_table, m_migration_index))
+			{
+				// Slots before the migration index stay empty, since the backward shift stops at an empty slot
+				m_migration_index++;
+				if ((m_migration_index & (((size_t) 1 << BLOCK_SIZE_LOG2) - 1)) == 0 || m_migration_index > m_old_table.mask)
+				{
+					release_block(m_old_table, (m_migration_index - 1) >> BLOCK_SIZE_LOG2);
+				}
+			}
+			else
+			{
+				// The backward shift may refill this slot, hence the index is not advanced
+				insert_new(m_table, m_old_table.key_list[m_migration_index], std::move(m_old_table.value_list[m_migration_index]));
+				remove_index(m_old_table, m_migration_index);
+			}
+		}
+	}
+
+	void grow_capacity(void)
+	{
+		migrate((size_t)(-1)); // Complete the previous migration if it is still in progress
+
+		m_old_table = m_table;
+		m_migration_index = 0;
+		allocate_table(m_table, __builtin_ctzll(m_old_table.mask + 1) + 1);
+		m_max_size = compute_max_size(m_table);
+
+		// Choose the pace so that the migration completes before the new table needs to grow
+		size_t step_total = m_old_table.mask + 1 + m_old_table.size;
+		size_t insertion_count = (m_max_size > m_old_table.size) ? (m_max_size - m_old_table.size) : 1;
+		m_migration_step = step_total / insertion_count + 2;
+	}
+
+public:
+
+	DynamicHashTable(void) noexcept {m_table.key_list = nullptr;}
+	DynamicHashTable(Alloc alloc, Free free, size_t capacity_log2, size_t max_load_percent) {m_table.key_list = nullptr; initialize(alloc, free, capacity_log2, max_load_percent);}
+	~DynamicHashTable(void) noexcept {uninitialize();}
+	DynamicHashTable(DynamicHashTable<Key, Value, KEY_INVALID, hash_func> const &) = delete;
+	DynamicHashTable(DynamicHashTable<Key, Value, KEY_INVALID, hash_func> &&) = delete;
+	void operator=(DynamicHashTable<Key, Value, KEY_INVALID, hash_func> const &) = delete;
+	void operator=(DynamicHashTable<Key, Value, KEY_INVALID, hash_func> &&) = delete;
+
+	bool is_initialized(void) const {return m_table.key_list != nullptr;}
+
+	void initialize(Alloc alloc, Free free, size_t capacity_log2, size_t max_load_percent)
+	{
+		TX_ASSERT(!is_initialized());
+		TX_ASSERT(capacity_log2 > 0);
+		TX_ASSERT(max_load_percent > 0 && max_load_percent < 100);
+
+		m_alloc = alloc;
+		m_free = free;
+		m_max_load_percent = max_load_percent;
+
+		allocate_table(m_table, capacity_log2);
+		m_max_size = compute_max_size(m_table);
+		m_old_table.key_list = nullptr;
+		m_migration_step = 0;
+	}
+
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+
+		if (is_migrating()) {free_table(m_old_table);}
+		free_table(m_table);
+	}
+
+	size_t get_size(void) const {return m_table.size + (is_migrating() ? m_old_table.size : 0);}
+	size_t get_capacity(void) const {return m_table.mask + 1;}
+
+	Value * find(Key const & key)
+	{
+		size_t index = find_index(m_table, key);
+		if (index != INDEX_INVALID) {return &m_table.value_list[index];}
+		if (is_migrating())
+		{
+			index = find_index(m_old_table, key);
+			if (index != INDEX_INVALID) {return &m_old_table.value_list[index];}
+		}
+		return nullptr;
+	}
+
+	Value const * find(Key const & key) const
+	{
+		return const_cast<DynamicHashTable<Key, Value, KEY_INVALID, hash_func> *>(this)->find(key);
+	}
+
+	void clear(void)
+	{
+		if (is_migrating()) {free_table(m_old_table);}
+		clear_table(m_table);
+	}
+
+	// Replace current value if it exists
+	void insert(Key const & key, Value const & value)
+	{
+		TX_ASSERT(key != KEY_INVALID);
+
+		migrate(m_migration_step);
+
+		Value * existing = find(key);
+		if (existing != nullptr)
+		{
+			*existing = value;
+			return;
+		}
+
+		if (m_table.size >= m_max_size)
+		{
+			grow_capacity();
+		}
+		insert_new(m_table, key, value);
 	}
 
+	// Remove the key if it exists
+	void remove(Key const & key)
+	{
+		TX_ASSERT(key != KEY_INVALID);
+
+		size_t index = find_index(m_table, key);
+		if (index != INDEX_INVALID)
+		{
+			remove_index(m_table, index);
+		}
+		else if (is_migrating())
+		{
+			index = find_index(m_old_table, key);
+			if (index != INDEX_INVALID) {remove_index(m_old_table, index);}
+		}
+
+		migrate(m_migration_step);
+	}
 
 };
 
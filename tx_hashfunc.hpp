@@ -0,0 +1,240 @@
+/*
+ * tx_hashfunc.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "tx_assert.h"
+
+namespace TXLib
+{
+
+// Hash functions and range reduction for the hash tables
+// hash_index<Key, CAPACITY> can be used directly as the hash_func of HashTable and ForgetfulHash:
+//   HashTable<uint32_t, Value, 1024, KEY_INVALID, hash_index<uint32_t, 1024>>
+// The 64-bit hashes follow wyhash (final version 4) and assume a little-endian processor
+
+
+static constexpr uint64_t const HASH_SEED = 0xA0761D6478BD642Full;
+
+namespace HashDetail
+{
+
+static constexpr uint64_t const SECRET[4] = {0x2D358DCCAA6C78A5ull, 0x8BB84B93962EACC9ull, 0x4B33A62ED433D4A3ull, 0x4D5A2DA51DE1AA47ull};
+
+// Full 128-bit product of @a and @b; the low half is returned in @a and the high half in @b
+constexpr void multiply(uint64_t & a, uint64_t & b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = (__uint128_t) a * b;
+	a = (uint64_t) product;
+	b = (uint64_t)(product >> 64);
+#else
+	// 32-bit processors: compose from four 32x32->64 products (UMULL on Cortex-M3 and above)
+	uint64_t a_high = a >> 32, a_low = (uint32_t) a;
+	uint64_t b_high = b >> 32, b_low = (uint32_t) b;
+	uint64_t high_high = a_high * b_high;
+	uint64_t high_low = a_high * b_low;
+	uint64_t low_high = a_low * b_high;
+	uint64_t low_low = a_low * b_low;
+	uint64_t middle = high_low + (low_low >> 32) + (uint32_t) low_high;
+	a = (middle << 32) | (uint32_t) low_low;
+	b = high_high + (middle >> 32) + (low_high >> 32);
+#endif
+}
+
+constexpr uint64_t mix(uint64_t a, uint64_t b)
+{
+	multiply(a, b);
+	return a ^ b;
+}
+
+// Little-endian unaligned reads; Cortex-M0 faults on unaligned word access
+// Composed from bytes in constant expressions, where memcpy is not allowed
+template <typename Byte>
+constexpr uint64_t read(Byte const * p, size_t count)
+{
+	uint64_t value = 0;
+	if (!__builtin_is_constant_evaluated())
+	{
+		__builtin_memcpy(&value, p, count);
+		return value;
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		value |= (uint64_t)(uint8_t) p[i] << (8 * i);
+	}
+	return value;
+}
+
+template <typename Byte> constexpr uint64_t read8(Byte const * p) {return read(p, 8);}
+template <typename Byte> constexpr uint64_t read4(Byte const * p) {return read(p, 4);}
+template <typename Byte> constexpr uint64_t read3(Byte const * p, size_t size) {return ((uint64_t)(uint8_t) p[0] << 16) | ((uint64_t)(uint8_t) p[size >> 1] << 8) | (uint8_t) p[size - 1];}
+
+}
+
+
+// Bijective 32-bit mixer (lowbias32); cheap on processors without a 64-bit multiplier
+constexpr uint32_t hash_u32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352Du;
+	x ^= x >> 15;
+	x *= 0x846CA68Bu;
+	x ^= x >> 16;
+	return x;
+}
+
+constexpr uint64_t hash_u64(uint64_t x, uint64_t seed = HASH_SEED)
+{
+	uint64_t a = x ^ HashDetail::SECRET[0];
+	uint64_t b = seed ^ HashDetail::SECRET[1];
+	HashDetail::multiply(a, b);
+	return HashDetail::mix(a ^ HashDetail::SECRET[0], b ^ HashDetail::SECRET[1]);
+}
+
+namespace HashDetail
+{
+
+template <typename Byte>
+constexpr uint64_t hash_bytes(Byte const * p, size_t size, uint64_t seed)
+{
+	seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+	uint64_t a = 0, b = 0;
+	if (size <= 16)
+	{
+		if (size >= 4)
+		{
+			size_t offset = (size >> 3) << 2;
+			a = (read4(p) << 32) | read4(p + offset);
+			b = (read4(p + size - 4) << 32) | read4(p + size - 4 - offset);
+		}
+		else if (size > 0)
+		{
+			a = read3(p, size);
+		}
+	}
+	else
+	{
+		size_t remain = size;
+		if (remain > 48)
+		{
+			// Three independent lanes to hide the multiplier latency
+			uint64_t seed1 = seed, seed2 = seed;
+			do
+			{
+				seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+				seed1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ seed1);
+				seed2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ seed2);
+				p += 48;
+				remain -= 48;
+			} while (remain > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (remain > 16)
+		{
+			seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+			p += 16;
+			remain -= 16;
+		}
+		a = read8(p + remain - 16);
+		b = read8(p + remain - 8);
+	}
+	a ^= SECRET[1];
+	b ^= seed;
+	multiply(a, b);
+	return mix(a ^ SECRET[0] ^ size, b ^ SECRET[1]);
+}
+
+}
+
+inline uint64_t hash_bytes(void const * data, size_t size, uint64_t seed = HASH_SEED)
+{
+	return HashDetail::hash_bytes((uint8_t const *) data, size, seed);
+}
+
+// Usable in constant expressions, e.g. for the keys of PerfectHashTable
+constexpr uint64_t hash_bytes(char const * data, size_t size, uint64_t seed = HASH_SEED)
+{
+	return HashDetail::hash_bytes(data, size, seed);
+}
+
+// Hash of a sequence: fold the hash of each element into @seed
+constexpr uint64_t hash_combine(uint64_t seed, uint64_t hash)
+{
+	return HashDetail::mix(seed ^ HashDetail::SECRET[0], hash ^ HashDetail::SECRET[1]);
+}
+
+// 64-bit hash with all bits usable, e.g. by the filters of tx_filter.hpp
+// Integers, enumerations and pointers are mixed; other types are hashed by their bytes, hence must not contain padding
+template <typename Type>
+constexpr uint64_t hash_value(Type const & value)
+{
+	if constexpr (std::is_enum<Type>::value)
+	{
+		return hash_value((typename std::underlying_type<Type>::type) value);
+	}
+	else if constexpr (std::is_pointer<Type>::value)
+	{
+		return hash_value((uintptr_t) value);
+	}
+	else if constexpr (std::is_integral<Type>::value && sizeof(Type) <= sizeof(uint64_t))
+	{
+		return hash_u64((uint64_t) value);
+	}
+	else
+	{
+		static_assert(std::has_unique_object_representations<Type>::value, "Type must be hashed by a dedicated function");
+		return hash_bytes(&value, sizeof(Type));
+	}
+}
+
+// Hash of several values, e.g. the members of a composite key
+template <typename Type, typename... Types>
+constexpr uint64_t hash_values(Type const & value, Types const &... values)
+{
+	uint64_t hash = hash_value(value);
+	((hash = hash_combine(hash, hash_value(values))), ...);
+	return hash;
+}
+
+// Map a uniformly distributed 32-bit hash onto [0, range) with a multiplication instead of a division (Lemire's fastrange)
+// The result depends on the high bits of @hash
+constexpr uint32_t reduce_range(uint32_t hash, uint32_t range)
+{
+	return (uint32_t)(((uint64_t) hash * range) >> 32);
+}
+
+// Map any 32-bit value onto [0, 2^range_log2) by multiply-shift (Fibonacci hashing)
+// The multiplication spreads the input bits into the high bits; enough for keys without adversarial structure
+inline uint32_t reduce_power_of_two(uint32_t value, size_t range_log2)
+{
+	TX_ASSERT(range_log2 > 0 && range_log2 <= 32);
+	return (uint32_t)(value * 0x9E3779B9u) >> (32 - range_log2);
+}
+
+// hash_func for the hash tables: hash @key and reduce it onto [0, CAPACITY)
+template <typename Key, size_t CAPACITY>
+constexpr size_t hash_index(Key key)
+{
+	static_assert(CAPACITY > 0 && CAPACITY <= 0xFFFFFFFFu);
+	if constexpr (std::is_integral<Key>::value && sizeof(Key) <= sizeof(uint32_t))
+	{
+		return reduce_range(hash_u32((uint32_t) key), (uint32_t) CAPACITY);
+	}
+	else
+	{
+		uint64_t hash = hash_value(key);
+		return reduce_range((uint32_t)(hash ^ (hash >> 32)), (uint32_t) CAPACITY);
+	}
+}
+
+
+
+}
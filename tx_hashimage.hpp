@@ -0,0 +1,203 @@
+/*
+ * tx_hashimage.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "tx_assert.h"
+#include "tx_hash.hpp"
+
+namespace TXLib
+{
+
+// Immutable image of a HashTable, position-independent so that it can be used in place:
+// stored in flash, linked as a constant, or mapped from a file by the host
+// write() serializes a table into a buffer of IMAGE_SIZE bytes; open() validates an image and find() searches it without copying
+// Layout (little-endian, every section aligned to SECTION_ALIGNMENT from the start of the image):
+//   Header
+//   control bytes: CAPACITY slots followed by mirrors of the first MIRROR_SIZE slots, so that any group size up to 16 can be loaded
+//   keys: CAPACITY slots, zero in empty slots
+//   values: CAPACITY slots, zero in empty slots
+// The reader must be instantiated with the same parameters, in particular the same hash_func and tag_func, as the table that was written
+template <typename Key, typename Value, size_t CAPACITY, Key const & KEY_INVALID, size_t hash_func(Key), uint8_t tag_func(Key const &, size_t) = hash_tag<Key>>
+class HashImage
+{
+	static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value);
+
+public:
+
+	typedef HashTable<Key, Value, CAPACITY, KEY_INVALID, hash_func, tag_func> Table;
+
+	static constexpr uint32_t const MAGIC = 0x49485854;	// "TXHI"
+	static constexpr uint16_t const VERSION = 2;	// Version 1 derived the tags from the hashed position
+
+	struct Header
+	{
+		uint32_t		magic;
+		uint16_t		version;
+		uint16_t		header_size;
+		uint32_t		key_size;
+		uint32_t		value_size;
+		uint32_t		capacity;
+		uint32_t		size;
+		uint32_t		distance_max;
+		uint32_t		control_offset;
+		uint32_t		key_offset;
+		uint32_t		value_offset;
+		uint32_t		image_size;
+	};
+
+private:
+
+	static constexpr size_t const SECTION_ALIGNMENT = 16;
+	static constexpr size_t const MIRROR_SIZE = 15;
+	static_assert(HashControlGroup::SIZE - 1 <= MIRROR_SIZE);
+
+	static constexpr size_t align(size_t offset) {return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);}
+
+	static constexpr size_t const CONTROL_OFFSET = align(sizeof(Header));
+	static constexpr size_t const KEY_OFFSET = align(CONTROL_OFFSET + CAPACITY + MIRROR_SIZE);
+	static constexpr size_t const VALUE_OFFSET = align(KEY_OFFSET + CAPACITY * sizeof(Key));
+
+public:
+
+	static constexpr size_t const IMAGE_SIZE = align(VALUE_OFFSET + CAPACITY * sizeof(Value));
+	static_assert(alignof(Key) <= SECTION_ALIGNMENT && alignof(Value) <= SECTION_ALIGNMENT && IMAGE_SIZE <= 0xFFFFFFFFu);
+
+private:
+
+	uint8_t const *			m_control_list;
+	Key const *					m_key_list;
+	Value const *				m_value_list;
+	size_t							m_size;
+	size_t							m_distance_max;
+
+private:
+
+	static size_t wrap_index(size_t index)
+	{
+		while (index >= CAPACITY) {index -= CAPACITY;}
+		return index;
+	}
+
+public:
+
+	HashImage(void) : m_control_list(nullptr) {}
+
+	// Write @table to @buffer, which must hold IMAGE_SIZE bytes and be aligned to SECTION_ALIGNMENT
+	static void write(Table const & table, void * buffer)
+	{
+		TX_ASSERT(((uintptr_t) buffer & (SECTION_ALIGNMENT - 1)) == 0);
+
+		uint8_t * image = (uint8_t *) buffer;
+		memset(image, 0, IMAGE_SIZE);
+
+		Header header;
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.header_size = sizeof(Header);
+		header.key_size = sizeof(Key);
+		header.value_size = sizeof(Value);
+		header.capacity = CAPACITY;
+		header.size = table.get_size();
+		header.distance_max = table.distance_max;
+		header.control_offset = CONTROL_OFFSET;
+		header.key_offset = KEY_OFFSET;
+		header.value_offset = VALUE_OFFSET;
+		header.image_size = IMAGE_SIZE;
+		memcpy(image, &header, sizeof(Header));
+
+		uint8_t * control_list = image + CONTROL_OFFSET;
+		for (size_t i = 0; i < CAPACITY; i++)
+		{
+			if (table.index_is_free(i))
+			{
+				control_list[i] = HashControlGroup::EMPTY;
+			}
+			else
+			{
+				control_list[i] = table.control_list[i];
+				memcpy(image + KEY_OFFSET + i * sizeof(Key), &table.key_list[i], sizeof(Key));
+				memcpy(image + VALUE_OFFSET + i * sizeof(Value), &table.value_list[i], sizeof(Value));
+			}
+		}
+		for (size_t i = 0; i < MIRROR_SIZE; i++)
+		{
+			control_list[CAPACITY + i] = control_list[i % CAPACITY];
+		}
+	}
+
+	bool is_open(void) const {return m_control_list != nullptr;}
+
+	// Use the image at @data in place; it must remain valid while the image is open
+	// Return false if @data is not an image of this table type
+	bool open(void const * data, size_t size)
+	{
+		m_control_list = nullptr;
+		if (((uintptr_t) data & (SECTION_ALIGNMENT - 1)) != 0 || size < sizeof(Header)) {return false;}
+
+		Header header;
+		memcpy(&header, data, sizeof(Header));
+		if (header.magic != MAGIC || header.version != VERSION || header.header_size != sizeof(Header)
+				|| header.key_size != sizeof(Key) || header.value_size != sizeof(Value) || header.capacity != CAPACITY
+				|| header.control_offset != CONTROL_OFFSET || header.key_offset != KEY_OFFSET || header.value_offset != VALUE_OFFSET
+				|| header.image_size != IMAGE_SIZE || size < IMAGE_SIZE
+				|| header.size >= CAPACITY || header.distance_max >= CAPACITY)
+		{
+			return false;
+		}
+
+		uint8_t const * image = (uint8_t const *) data;
+		m_control_list = image + CONTROL_OFFSET;
+		m_key_list = (Key const *)(image + KEY_OFFSET);
+		m_value_list = (Value const *)(image + VALUE_OFFSET);
+		m_size = header.size;
+		m_distance_max = header.distance_max;
+		return true;
+	}
+
+	void close(void) {m_control_list = nullptr;}
+
+	size_t get_size(void) const {TX_ASSERT(is_open()); return m_size;}
+	size_t get_capacity(void) const {return CAPACITY;}
+
+	// Same probing as HashTable::find_index()
+	Value const * find(Key const & key) const
+	{
+		TX_ASSERT(is_open());
+
+		size_t index = hash_func(key);
+		TX_ASSERT(index < CAPACITY);
+		uint8_t tag = Table::compute_tag(key, index);
+
+		size_t distance = 0;
+		while (1)
+		{
+			HashControlGroup group(m_control_list + index);
+			HashControlGroup::Mask empty = group.match_empty();
+			HashControlGroup::Mask match = group.match(tag) & HashControlGroup::slots_before(empty);
+			while (match != 0)
+			{
+				size_t index_match = wrap_index(index + HashControlGroup::lowest_slot(match));
+				if (m_key_list[index_match] == key) {return &m_value_list[index_match];}
+				match = HashControlGroup::remove_lowest_slot(match);
+			}
+			if (empty != 0) {return nullptr;}
+			distance += HashControlGroup::SIZE;
+			if (distance > m_distance_max) {return nullptr;}
+			index = wrap_index(index + HashControlGroup::SIZE);
+		}
+	}
+
+};
+
+
+
+}
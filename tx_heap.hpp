@@ -9,30 +9,73 @@
 
 #include <stddef.h>
 #include <utility>
+#include <new>
+#include <type_traits>
 #include "tx_assert.h"
 
 namespace TXLib
 {
 
+// Adapts a comparison function to a stateless comparator type
+template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b)>
+struct CompareFunction
+{
+	bool operator()(Type const & a, Type const & b) const {return is_larger_or_equal(a, b);}
+};
+
+// Storage of a comparator object
+// Empty comparators (stateless functors, captureless lambdas) take no space thanks to the empty base optimization
+template <typename Compare, bool IS_INHERITABLE = std::is_class<Compare>::value && !std::is_final<Compare>::value>
+class CompareHolder : private Compare
+{
+protected:
+	CompareHolder(void) = default;
+	CompareHolder(Compare const & compare) noexcept : Compare(compare) {}
+
+public:
+	Compare & get_compare(void) {return *this;}
+	Compare const & get_compare(void) const {return *this;}
+};
+
+template <typename Compare>
+class CompareHolder<Compare, false>
+{
+private:
+	Compare				m_compare;
+
+protected:
+	CompareHolder(void) = default;
+	CompareHolder(Compare const & compare) noexcept : m_compare(compare) {}
+
+public:
+	Compare & get_compare(void) {return m_compare;}
+	Compare const & get_compare(void) const {return m_compare;}
+};
+
+
 // Max heap structure
 // The top is larger or equal to every other item
 // Inserted item will only replace the top if it is strictly larger than the top
-template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b), size_t CAPACITY>
-class Heap
+// @Compare is a comparator type; compare(a, b) returns true iff a is larger or equal to b
+template <typename Type, typename Compare, size_t CAPACITY>
+class BasicHeap : public CompareHolder<Compare>
 {
 private:
 	Type 				m_heap[CAPACITY];
 	size_t	 		m_size;
 
+private:
+	bool is_larger_or_equal(Type const & a, Type const & b) const {return this->get_compare()(a, b);}
 
 public:
 
-	Heap(void) noexcept : m_size(0) {}
-	~Heap(void) noexcept = default;
-	Heap(Heap<Type, is_larger_or_equal, CAPACITY> const &) = delete;
-	Heap(Heap<Type, is_larger_or_equal, CAPACITY> &&) = delete;
-	void operator=(Heap<Type, is_larger_or_equal, CAPACITY> const &) = delete;
-	void operator=(Heap<Type, is_larger_or_equal, CAPACITY> &&) = delete;
+	BasicHeap(void) noexcept : m_size(0) {}
+	explicit BasicHeap(Compare const & compare) noexcept : CompareHolder<Compare>(compare), m_size(0) {}
+	~BasicHeap(void) noexcept = default;
+	BasicHeap(BasicHeap<Type, Compare, CAPACITY> const &) = delete;
+	BasicHeap(BasicHeap<Type, Compare, CAPACITY> &&) = delete;
+	void operator=(BasicHeap<Type, Compare, CAPACITY> const &) = delete;
+	void operator=(BasicHeap<Type, Compare, CAPACITY> &&) = delete;
 
 	Type const & get_top(void) const
 	{
@@ -113,10 +156,13 @@ public:
 
 };
 
+template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b), size_t CAPACITY>
+using Heap = BasicHeap<Type, CompareFunction<Type, is_larger_or_equal>, CAPACITY>;
 
 
-template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b)>
-class DynamicHeap
+
+template <typename Type, typename Compare>
+class BasicDynamicHeap : public CompareHolder<Compare>
 {
 public:
 	typedef				void * (*Alloc)(size_t);
@@ -135,6 +181,8 @@ private:
 	size_t parent_index(size_t index) const {return (index - 1) >> 1u;}
 	size_t child_index(size_t index) const {return 2 * index + 1;}
 
+	bool is_larger_or_equal(Type const & a, Type const & b) const {return this->get_compare()(a, b);}
+
 	void grow_capacity(void)
 	{
 		m_capacity_log2 ++;
@@ -197,12 +245,13 @@ private:
 
 public:
 
-	DynamicHeap(void) noexcept : m_heap(nullptr) {}
-	~DynamicHeap(void) noexcept {uninitialize();}
-	DynamicHeap(DynamicHeap<Type, is_larger_or_equal> const &) = delete;
-	DynamicHeap(DynamicHeap<Type, is_larger_or_equal> &&) = delete;
-	void operator=(DynamicHeap<Type, is_larger_or_equal> const &) = delete;
-	void operator=(DynamicHeap<Type, is_larger_or_equal> &&) = delete;
+	BasicDynamicHeap(void) noexcept : m_heap(nullptr) {}
+	explicit BasicDynamicHeap(Compare const & compare) noexcept : CompareHolder<Compare>(compare), m_heap(nullptr) {}
+	~BasicDynamicHeap(void) noexcept {uninitialize();}
+	BasicDynamicHeap(BasicDynamicHeap<Type, Compare> const &) = delete;
+	BasicDynamicHeap(BasicDynamicHeap<Type, Compare> &&) = delete;
+	void operator=(BasicDynamicHeap<Type, Compare> const &) = delete;
+	void operator=(BasicDynamicHeap<Type, Compare> &&) = delete;
 
 	bool is_initialized(void) const {return m_heap != nullptr;}
 
@@ -319,11 +368,14 @@ public:
 
 };
 
+template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b)>
+using DynamicHeap = BasicDynamicHeap<Type, CompareFunction<Type, is_larger_or_equal>>;
 
 
 
-template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b), size_t CAPACITY>
-class MinMaxHeap
+
+template <typename Type, typename Compare, size_t CAPACITY>
+class BasicMinMaxHeap : public CompareHolder<Compare>
 /* A binary tree in which nodes in even rows are smaller than their descendants, and nodes in odd rows are larger than their descendants
  * The row containing the row is indexed by 0.
  */
@@ -335,6 +387,8 @@ private:
 
 private:
 
+	bool is_larger_or_equal(Type const & a, Type const & b) const {return this->get_compare()(a, b);}
+
 	size_t grandparent_index(size_t index) const {return (index - 3) >> 2u;}
 	size_t parent_index(size_t index) const {return (index - 1) >> 1u;}
 	size_t grandchild_index(size_t index) const {return 4 * index + 3;};
@@ -442,12 +496,13 @@ private:
 
 public:
 
-	MinMaxHeap(void) noexcept : m_size(0) {}
-	~MinMaxHeap(void) noexcept = default;
-	MinMaxHeap(MinMaxHeap<Type, is_larger_or_equal, CAPACITY> const &) = delete;
-	MinMaxHeap(MinMaxHeap<Type, is_larger_or_equal, CAPACITY> &&) = delete;
-	void operator=(MinMaxHeap<Type, is_larger_or_equal, CAPACITY> const &) = delete;
-	void operator=(MinMaxHeap<Type, is_larger_or_equal, CAPACITY> &&) = delete;
+	BasicMinMaxHeap(void) noexcept : m_size(0) {}
+	explicit BasicMinMaxHeap(Compare const & compare) noexcept : CompareHolder<Compare>(compare), m_size(0) {}
+	~BasicMinMaxHeap(void) noexcept = default;
+	BasicMinMaxHeap(BasicMinMaxHeap<Type, Compare, CAPACITY> const &) = delete;
+	BasicMinMaxHeap(BasicMinMaxHeap<Type, Compare, CAPACITY> &&) = delete;
+	void operator=(BasicMinMaxHeap<Type, Compare, CAPACITY> const &) = delete;
+	void operator=(BasicMinMaxHeap<Type, Compare, CAPACITY> &&) = delete;
 
 	Type const & get_min(void) const
 	{
@@ -546,6 +601,375 @@ public:
 
 };
 
+template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b), size_t CAPACITY>
+using MinMaxHeap = BasicMinMaxHeap<Type, CompareFunction<Type, is_larger_or_equal>, CAPACITY>;
+
+
+
+// Max pairing heap with node handles
+// Insertion and melding are constant-time; pop and removal are amortized logarithmic-time
+// Nodes are carved from slabs of 2^(slab_size_log2) nodes allocated through @Alloc and recycled through a free list
+template <typename Type, typename Compare>
+class BasicPairingHeap : public CompareHolder<Compare>
+{
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+private:
+	struct Node
+	{
+		Node *				child;		// First child
+		Node *				sibling;	// Next sibling
+		Node *				prev;			// Parent if this is the first child, previous sibling otherwise; nullptr for the root
+		Type					item;
+
+		template <typename... Args>
+		Node(Args && ... args) noexcept : child(nullptr), sibling(nullptr), prev(nullptr), item(std::forward<Args>(args) ...) {}
+	};
+
+	struct FreeNode
+	{
+		FreeNode *		next;
+	};
+
+	struct Slab
+	{
+		Slab *				next;
+	};
+
+	static constexpr size_t const SLAB_HEADER_SIZE = ((sizeof(Slab) + alignof(Node) - 1) / alignof(Node)) * alignof(Node);
+	static_assert(sizeof(Node) >= sizeof(FreeNode));
+
+public:
+
+	class Handle
+	{
+		friend BasicPairingHeap<Type, Compare>;
+
+	private:
+		Node *			m_node;
+
+	private:
+		inline Handle(Node * node) noexcept : m_node(node) {}
+
+	public:
+		inline Handle(void) noexcept : m_node(nullptr) {}
+		inline Handle(Handle const &) noexcept = default;
+		inline Handle & operator=(Handle const &) noexcept = default;
+		inline ~Handle(void) noexcept = default;
+		inline bool is_invalid(void) const {return m_node == nullptr;}
+		inline void set_invalid(void) {m_node = nullptr;}
+		inline bool operator==(Handle const & b) const {return m_node == b.m_node;}
+		inline bool operator!=(Handle const & b) const {return m_node != b.m_node;}
+	};
+
+private:
+	Node *				m_root;
+	size_t				m_size;
+
+	FreeNode *		m_free_head;
+	FreeNode *		m_free_tail;
+	Slab *				m_slab_head;
+	Slab *				m_slab_tail;
+	size_t				m_slab_size_log2;
+
+	Alloc					m_alloc;
+	Free					m_free;
+
+private:
+
+	bool is_larger_or_equal(Type const & a, Type const & b) const {return this->get_compare()(a, b);}
+
+	void grow_free_list(void)
+	{
+		Slab * slab = (Slab *) m_alloc(SLAB_HEADER_SIZE + (1u << m_slab_size_log2) * sizeof(Node));
+		slab->next = nullptr;
+		if (m_slab_tail == nullptr) {m_slab_head = slab;}
+		else {m_slab_tail->next = slab;}
+		m_slab_tail = slab;
+
+		Node * nodes = (Node *)((size_t) slab + SLAB_HEADER_SIZE);
+		for (size_t i = 0; i < (1u << m_slab_size_log2); i++)
+		{
+			release_slot(nodes + i);
+		}
+	}
+
+	void release_slot(Node * node)
+	{
+		FreeNode * slot = (FreeNode *) node;
+		slot->next = m_free_head;
+		if (m_free_head == nullptr) {m_free_tail = slot;}
+		m_free_head = slot;
+	}
+
+	Node * acquire_slot(void)
+	{
+		if (m_free_head == nullptr) {grow_free_list();}
+		FreeNode * slot = m_free_head;
+		m_free_head = slot->next;
+		if (m_free_head == nullptr) {m_free_tail = nullptr;}
+		return (Node *) slot;
+	}
+
+	Node * link(Node * a, Node * b)
+	/* Make the smaller of the two roots @a and @b the first child of the other
+	 * Return the new root; its @sibling and @prev fields are cleared
+	 */
+	{
+		if (!is_larger_or_equal(a->item, b->item))
+		{
+			Node * temp = a;
+			a = b;
+			b = temp;
+		}
+
+		b->prev = a;
+		b->sibling = a->child;
+		if (a->child != nullptr) {a->child->prev = b;}
+		a->child = b;
+
+		a->sibling = nullptr;
+		a->prev = nullptr;
+		return a;
+	}
+
+	Node * merge_pairs(Node * first)
+	// Merge the list of siblings starting at @first into a single tree using the two-pass scheme
+	{
+		if (first == nullptr) {return nullptr;}
+
+		// First pass: link siblings pairwise from left to right, stacking the results through @sibling
+		Node * stack = nullptr;
+		while (first != nullptr)
+		{
+			Node * a = first;
+			Node * b = a->sibling;
+			if (b == nullptr)
+			{
+				a->sibling = stack;
+				stack = a;
+				break;
+			}
+			first = b->sibling;
+			Node * pair = link(a, b);
+			pair->sibling = stack;
+			stack = pair;
+		}
+
+		// Second pass: link the stacked trees from right to left
+		Node * root = stack;
+		stack = stack->sibling;
+		root->sibling = nullptr;
+		while (stack != nullptr)
+		{
+			Node * next = stack->sibling;
+			root = link(root, stack);
+			stack = next;
+		}
+		root->prev = nullptr;
+		return root;
+	}
+
+	void detach(Node * node)
+	// Cut the subtree rooted at @node from its parent; @node cannot be the root
+	{
+		if (node->prev->child == node) {node->prev->child = node->sibling;}
+		else {node->prev->sibling = node->sibling;}
+		if (node->sibling != nullptr) {node->sibling->prev = node->prev;}
+		node->sibling = nullptr;
+		node->prev = nullptr;
+	}
+
+	void destroy_tree(Node * root)
+	{
+		Node * stack = root;
+		while (stack != nullptr)
+		{
+			Node * node = stack;
+			stack = node->sibling;
+			for (Node * child = node->child; child != nullptr;)
+			{
+				Node * next = child->sibling;
+				child->sibling = stack;
+				stack = child;
+				child = next;
+			}
+			node->~Node();
+			release_slot(node);
+		}
+	}
+
+public:
+
+	BasicPairingHeap(void) noexcept : m_alloc(nullptr) {}
+	explicit BasicPairingHeap(Compare const & compare) noexcept : CompareHolder<Compare>(compare), m_alloc(nullptr) {}
+	BasicPairingHeap(Alloc alloc, Free free, size_t slab_size_log2) : m_alloc(nullptr) {initialize(alloc, free, slab_size_log2);}
+	~BasicPairingHeap(void) noexcept {uninitialize();}
+	BasicPairingHeap(BasicPairingHeap<Type, Compare> const &) = delete;
+	BasicPairingHeap(BasicPairingHeap<Type, Compare> &&) = delete;
+	void operator=(BasicPairingHeap<Type, Compare> const &) = delete;
+	void operator=(BasicPairingHeap<Type, Compare> &&) = delete;
+
+	bool is_initialized(void) const {return m_alloc != nullptr;}
+
+	void initialize(Alloc alloc, Free free, size_t slab_size_log2)
+	{
+		TX_ASSERT(!is_initialized());
+
+		m_root = nullptr;
+		m_size = 0;
+		m_free_head = nullptr;
+		m_free_tail = nullptr;
+		m_slab_head = nullptr;
+		m_slab_tail = nullptr;
+		m_slab_size_log2 = slab_size_log2;
+		m_alloc = alloc;
+		m_free = free;
+	}
+
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+
+		clear();
+		while (m_slab_head != nullptr)
+		{
+			Slab * next = m_slab_head->next;
+			m_free(m_slab_head);
+			m_slab_head = next;
+		}
+		m_alloc = nullptr;
+	}
+
+	size_t get_size(void) const {return m_size;}
+
+	Type const & get_top(void) const
+	{
+		TX_ASSERT(m_size > 0);
+		return m_root->item;
+	}
+
+	Type const & operator[](Handle const & handle) const
+	{
+		TX_ASSERT(!handle.is_invalid());
+		return handle.m_node->item;
+	}
+
+	// Constant-time
+	template <typename... Args>
+	Handle insert(Args && ... args)
+	{
+		TX_ASSERT(is_initialized());
+
+		Node * node = ::new(acquire_slot()) Node(std::forward<Args>(args) ...);
+		m_root = (m_root == nullptr) ? node : link(m_root, node);
+		m_size++;
+		return Handle(node);
+	}
+
+	// Amortized logarithmic-time
+	Type pop_top(void)
+	{
+		TX_ASSERT(m_size > 0);
+
+		Node * node = m_root;
+		Type top = std::move(node->item);
+		m_root = merge_pairs(node->child);
+		node->~Node();
+		release_slot(node);
+		m_size--;
+		return top;
+	}
+
+	// Replace the item referred to by @handle by an item that is larger or equal
+	// This is the max-heap counterpart of decrease-key
+	template <typename... Args>
+	void increase_key(Handle const & handle, Args && ... args)
+	{
+		TX_ASSERT(!handle.is_invalid());
+
+		Node * node = handle.m_node;
+		Type item = Type(std::forward<Args>(args) ...);
+		TX_ASSERT(is_larger_or_equal(item, node->item));
+		node->item = std::move(item);
+
+		if (node != m_root)
+		{
+			detach(node);
+			m_root = link(m_root, node);
+		}
+	}
+
+	// Amortized logarithmic-time
+	Type remove(Handle & handle)
+	{
+		TX_ASSERT(!handle.is_invalid());
+
+		Node * node = handle.m_node;
+		handle.set_invalid();
+		if (node == m_root) {return pop_top();}
+
+		detach(node);
+		Node * subtree = merge_pairs(node->child);
+		if (subtree != nullptr) {m_root = link(m_root, subtree);}
+
+		Type item = std::move(node->item);
+		node->~Node();
+		release_slot(node);
+		m_size--;
+		return item;
+	}
+
+	// Move all items of @other into @this in constant time
+	// Handles obtained from @other remain valid and now refer to items of @this
+	// Both heaps must use the same allocator
+	void meld(BasicPairingHeap<Type, Compare> & other)
+	{
+		TX_ASSERT(is_initialized() && other.is_initialized());
+		TX_ASSERT(m_alloc == other.m_alloc && m_free == other.m_free);
+
+		if (other.m_root != nullptr)
+		{
+			m_root = (m_root == nullptr) ? other.m_root : link(m_root, other.m_root);
+			m_size += other.m_size;
+		}
+
+		// Take over the slabs of @other since they hold the melded nodes
+		if (other.m_slab_head != nullptr)
+		{
+			if (m_slab_tail == nullptr) {m_slab_head = other.m_slab_head;}
+			else {m_slab_tail->next = other.m_slab_head;}
+			m_slab_tail = other.m_slab_tail;
+		}
+		if (other.m_free_head != nullptr)
+		{
+			other.m_free_tail->next = m_free_head;
+			if (m_free_head == nullptr) {m_free_tail = other.m_free_tail;}
+			m_free_head = other.m_free_head;
+		}
+
+		other.m_root = nullptr;
+		other.m_size = 0;
+		other.m_free_head = nullptr;
+		other.m_free_tail = nullptr;
+		other.m_slab_head = nullptr;
+		other.m_slab_tail = nullptr;
+	}
+
+	void clear(void)
+	{
+		destroy_tree(m_root);
+		m_root = nullptr;
+		m_size = 0;
+	}
+
+};
+
+template <typename Type, bool is_larger_or_equal(Type const & a, Type const & b)>
+using PairingHeap = BasicPairingHeap<Type, CompareFunction<Type, is_larger_or_equal>>;
+
 
 
 
@@ -0,0 +1,129 @@
+/*
+ * tx_interner.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <string_view>
+#include "tx_assert.h"
+#include "tx_hash.hpp"
+#include "tx_stringkey.hpp"
+
+namespace TXLib
+{
+
+// Map strings to dense 32-bit IDs (0, 1, 2... in order of first interning), so that interned strings are compared as integers
+// The characters of each distinct string are stored once, NUL-terminated, in a bump arena of ARENA_SIZE bytes; nothing is freed before clear()
+// Strings are indexed by a HashTable of StringKey pointing into the arena, hence each string is hashed once when interned
+// Interning is not thread-safe; after freeze(), the interner is immutable and find() and get_string() can run in any number of threads without a lock
+template <size_t CAPACITY, size_t ARENA_SIZE>
+class Interner
+{
+public:
+
+	static constexpr uint32_t const ID_INVALID = 0xFFFFFFFF;
+
+private:
+
+	static constexpr size_t const TABLE_CAPACITY = CAPACITY + CAPACITY / 4 + 1;	// Load factor of at most 80%
+
+	static_assert(CAPACITY < ID_INVALID && ARENA_SIZE <= 0xFFFFFFFFu);
+
+private:
+
+	HashTable<StringKey, uint32_t, TABLE_CAPACITY, STRING_KEY_INVALID, string_key_index<TABLE_CAPACITY>, string_key_tag>		m_table;
+	uint32_t					m_offset_list[CAPACITY];	// Position of each string in the arena
+	uint32_t					m_size_list[CAPACITY];
+	size_t						m_size;
+	size_t						m_arena_used;
+	std::atomic<bool>	m_is_frozen;
+	char							m_arena[ARENA_SIZE];
+
+public:
+
+	Interner(void) noexcept : m_size(0), m_arena_used(0), m_is_frozen(false) {}
+	Interner(Interner const &) = delete;
+	Interner(Interner &&) = delete;
+	void operator=(Interner const &) = delete;
+	void operator=(Interner &&) = delete;
+
+	size_t get_size(void) const {return m_size;}
+	size_t get_capacity(void) const {return CAPACITY;}
+	size_t get_arena_used(void) const {return m_arena_used;}
+
+	// Return the ID of the string, interning it if it is new
+	// Return ID_INVALID if the string is new and the IDs or the arena are exhausted
+	uint32_t intern(std::string_view string)
+	{
+		TX_ASSERT(!is_frozen());
+
+		StringKey key(string);
+		uint32_t const * found = m_table.find(key);
+		if (found != nullptr) {return *found;}
+
+		if (m_size >= CAPACITY || ARENA_SIZE - m_arena_used < string.size() + 1) {return ID_INVALID;}
+
+		char * data = m_arena + m_arena_used;
+		memcpy(data, string.data(), string.size());
+		data[string.size()] = '\0';
+
+		uint32_t id = (uint32_t) m_size;
+		m_offset_list[id] = (uint32_t) m_arena_used;
+		m_size_list[id] = (uint32_t) string.size();
+		m_arena_used += string.size() + 1;
+		m_size++;
+
+		// The stored key points into the arena and keeps the hash computed above
+		m_table.insert(StringKey(data, string.size(), key.get_hash()), id);
+		return id;
+	}
+
+	// Return ID_INVALID if the string has not been interned
+	uint32_t find(std::string_view string) const
+	{
+		uint32_t const * found = m_table.find(StringKey(string));
+		return (found == nullptr) ? ID_INVALID : *found;
+	}
+
+	std::string_view get_string(uint32_t id) const
+	{
+		TX_ASSERT(id < m_size);
+		return std::string_view(m_arena + m_offset_list[id], m_size_list[id]);
+	}
+
+	// NUL-terminated
+	char const * get_c_string(uint32_t id) const
+	{
+		TX_ASSERT(id < m_size);
+		return m_arena + m_offset_list[id];
+	}
+
+	// Make the interner immutable; the memory written by this thread must be published to the reader threads
+	// (e.g. by starting them afterwards, or by their observing is_frozen() == true)
+	void freeze(void)
+	{
+		m_is_frozen.store(true, std::memory_order_release);
+	}
+
+	bool is_frozen(void) const {return m_is_frozen.load(std::memory_order_acquire);}
+
+	// Invalidate all IDs and views; the interner is no longer frozen
+	void clear(void)
+	{
+		m_table.clear();
+		m_size = 0;
+		m_arena_used = 0;
+		m_is_frozen.store(false, std::memory_order_relaxed);
+	}
+};
+
+
+
+}
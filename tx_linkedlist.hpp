@@ -9,6 +9,7 @@
 
 #include <stddef.h>
 #include "tx_assert.h"
+#include "tx_member.hpp"
 
 namespace TXLib
 {
@@ -175,5 +176,189 @@ inline void LinkedCycleUnsafe::insert_as_next_of(LinkedCycle & anchor)
 
 
 
+// Doubly linked list of objects that embed their link, a LinkedCycle member given by @LINK
+// The list owns no memory: objects are linked and unlinked in place, and must outlive their membership
+// An object can be in several lists at once through several links
+// If @TRACK_SIZE, the list counts its objects; this makes get_size() constant-time but splicing part of another list linear
+template <typename Type, LinkedCycle Type::* LINK, bool TRACK_SIZE = false>
+class IntrusiveList
+{
+private:
+
+	static Type & get_object(LinkedCycle & link) {return *get_container<Type, LinkedCycle, LINK>(&link);}
+	static LinkedCycle & get_link(Type & object) {return object.*LINK;}
+
+public:
+
+	template <typename Object, typename Link>
+	class IteratorBase
+	{
+		friend IntrusiveList;
+		template <typename, typename> friend class IteratorBase;
+
+	private:
+		Link *			m_link;
+
+	private:
+		explicit IteratorBase(Link * link) : m_link(link) {}
+
+	public:
+		IteratorBase(void) : m_link(nullptr) {}
+		operator IteratorBase<Type const, LinkedCycle const>(void) const {return IteratorBase<Type const, LinkedCycle const>(m_link);}
+
+		Object & operator*(void) const {return get_object(const_cast<LinkedCycle &>(*m_link));}
+		Object * operator->(void) const {return &**this;}
+
+		IteratorBase & operator++(void) {m_link = &m_link->next(); return *this;}
+		IteratorBase & operator--(void) {m_link = &m_link->prev(); return *this;}
+		IteratorBase operator++(int) {IteratorBase temp = *this; ++*this; return temp;}
+		IteratorBase operator--(int) {IteratorBase temp = *this; --*this; return temp;}
+
+		bool operator==(IteratorBase const & b) const {return m_link == b.m_link;}
+		bool operator!=(IteratorBase const & b) const {return m_link != b.m_link;}
+	};
+
+	typedef IteratorBase<Type, LinkedCycle> Iterator;
+	typedef IteratorBase<Type const, LinkedCycle const> ConstIterator;
+
+private:
+
+	LinkedCycle				m_anchor;		// Next is the front, prev is the back
+	size_t						m_size;			// Only maintained if TRACK_SIZE
+
+private:
+
+	void add_size(size_t count) {if constexpr (TRACK_SIZE) {m_size += count;}}
+	void subtract_size(size_t count) {if constexpr (TRACK_SIZE) {m_size -= count;}}
+
+	static LinkedCycle & get_position(Iterator position) {return *position.m_link;}
+
+	static void move_range(LinkedCycle & position, LinkedCycle & first, LinkedCycle & last)
+	// Move [@first, @last) before @position; the range cannot be empty or contain @position
+	{
+		// Close the range into its own cycle, then open it between @position and its predecessor
+		LinkedCycle & range_back = last.prev();
+		first.prev().criss_cross_with(last);
+		position.prev().criss_cross_with(first);
+		TX_ASSERT(&position.prev() == &range_back);
+	}
+
+public:
+
+	IntrusiveList(void) noexcept : m_size(0) {}
+	IntrusiveList(IntrusiveList const &) = delete;
+	IntrusiveList(IntrusiveList &&) = delete;
+	~IntrusiveList(void) noexcept {clear();}
+	void operator=(IntrusiveList const &) = delete;
+	void operator=(IntrusiveList &&) = delete;
+
+	bool is_empty(void) const {return m_anchor.is_single();}
+
+	size_t get_size(void) const
+	{
+		static_assert(TRACK_SIZE, "The size is only tracked if TRACK_SIZE");
+		return m_size;
+	}
+
+	Iterator begin(void) {return Iterator(&m_anchor.next());}
+	Iterator end(void) {return Iterator(&m_anchor);}
+	ConstIterator begin(void) const {return ConstIterator(&m_anchor.next());}
+	ConstIterator end(void) const {return ConstIterator(&m_anchor);}
+
+	// Iterator to an object in a list of this type
+	static Iterator get_iterator(Type & object) {return Iterator(&get_link(object));}
+
+	Type & front(void)
+	{
+		TX_ASSERT(!is_empty());
+		return get_object(m_anchor.next());
+	}
+
+	Type & back(void)
+	{
+		TX_ASSERT(!is_empty());
+		return get_object(m_anchor.prev());
+	}
+
+	// @object must not be in a list through @LINK
+	Iterator insert(Iterator position, Type & object)
+	{
+		get_link(object).insert_single_as_prev_of(get_position(position));
+		add_size(1);
+		return get_iterator(object);
+	}
+
+	void push_front(Type & object) {insert(begin(), object);}
+	void push_back(Type & object) {insert(end(), object);}
+
+	// @object must be in this list
+	// Return the iterator to the object that followed @object
+	Iterator erase(Type & object)
+	{
+		LinkedCycle & link = get_link(object);
+		TX_ASSERT(!link.is_single());
+		Iterator next(&link.next());
+		link.remove_from_cycle();
+		subtract_size(1);
+		return next;
+	}
+
+	Iterator erase(Iterator position) {return erase(*position);}
+
+	Type & pop_front(void)
+	{
+		Type & object = front();
+		erase(object);
+		return object;
+	}
+
+	Type & pop_back(void)
+	{
+		Type & object = back();
+		erase(object);
+		return object;
+	}
+
+	// Move all the objects of @other before @position; constant-time
+	void splice(Iterator position, IntrusiveList & other)
+	{
+		TX_ASSERT(&other != this);
+		if (other.is_empty()) {return;}
+		move_range(get_position(position), other.m_anchor.next(), other.m_anchor);
+		add_size(other.m_size);
+		other.m_size = 0;
+	}
+
+	// Move the objects [@first, @last) of @other before @position
+	// Constant-time, unless the size is tracked and @other is another list; @position cannot be in the range
+	void splice(Iterator position, IntrusiveList & other, Iterator first, Iterator last)
+	{
+		if (first == last) {return;}
+		if constexpr (TRACK_SIZE)
+		{
+			if (&other != this)
+			{
+				size_t count = 0;
+				for (Iterator it = first; it != last; ++it) {count++;}
+				other.subtract_size(count);
+				add_size(count);
+			}
+		}
+		move_range(get_position(position), get_position(first), get_position(last));
+	}
+
+	// Unlink every object; linear-time since every link is reset to single
+	void clear(void)
+	{
+		while (!m_anchor.is_single())
+		{
+			m_anchor.next().remove_from_cycle();
+		}
+		m_size = 0;
+	}
+};
+
+
+
 
 }
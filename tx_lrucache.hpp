@@ -0,0 +1,237 @@
+/*
+ * tx_lrucache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tx_assert.h"
+#include "tx_linkedlist.hpp"
+#include "tx_member.hpp"
+#include "tx_hashfunc.hpp"
+
+namespace TXLib
+{
+
+// Cache of at most CAPACITY entries that evicts the exact least recently used entry
+// Entries live in a fixed array of nodes; each node embeds the LinkedCycle of the recency order
+// The nodes are indexed by an open addressing table of node numbers with linear probing, at most half full;
+// slots and nodes also keep 32 bits of the key hash, so that most mismatches are rejected without comparing keys and no key is ever rehashed
+// Lookup, promotion, insertion and eviction are constant-time and never allocate
+template <typename Key, typename Value, size_t CAPACITY, uint64_t hash_func(Key const &) = hash_value<Key>>
+class LRUCache
+{
+private:
+
+	static constexpr size_t const TABLE_CAPACITY = 2 * CAPACITY;
+	static constexpr uint32_t const NODE_INVALID = 0xFFFFFFFF;
+
+	static_assert(CAPACITY > 0 && TABLE_CAPACITY < NODE_INVALID);
+
+	struct Node
+	{
+		LinkedCycle		link;		// In the recency cycle if used, in the free cycle otherwise
+		uint32_t			hash;
+		Key						key;
+		Value					value;
+	};
+
+	struct Slot
+	{
+		uint32_t			node;		// NODE_INVALID if the slot is empty
+		uint32_t			hash;
+	};
+
+private:
+
+	Node					m_node_list[CAPACITY];
+	Slot					m_slot_list[TABLE_CAPACITY];
+	LinkedCycle		m_recent_anchor;		// Next is the most recently used node
+	LinkedCycle		m_free_anchor;
+	size_t				m_size;
+
+private:
+
+	static uint32_t get_hash(Key const & key) {return (uint32_t) hash_func(key);}
+	static size_t get_slot(uint32_t hash) {return reduce_range(hash, (uint32_t) TABLE_CAPACITY);}
+
+	static size_t next_slot(size_t slot)
+	{
+		slot++;
+		return (slot == TABLE_CAPACITY) ? 0 : slot;
+	}
+
+	uint32_t get_node_index(LinkedCycle & link) {return (uint32_t)(get_container<Node, LinkedCycle, &Node::link>(&link) - m_node_list);}
+
+	size_t find_slot(Key const & key, uint32_t hash) const
+	// Return TABLE_CAPACITY if the key is absent
+	{
+		size_t slot = get_slot(hash);
+		while (m_slot_list[slot].node != NODE_INVALID)
+		{
+			if (m_slot_list[slot].hash == hash && m_node_list[m_slot_list[slot].node].key == key) {return slot;}
+			slot = next_slot(slot);
+		}
+		return TABLE_CAPACITY;
+	}
+
+	size_t find_node_slot(Node const & node) const
+	// @node must be used
+	{
+		uint32_t node_index = (uint32_t)(&node - m_node_list);
+		size_t slot = get_slot(node.hash);
+		while (m_slot_list[slot].node != node_index) {slot = next_slot(slot);}
+		return slot;
+	}
+
+	void remove_slot(size_t slot)
+	// Backward shift deletion: move up the following keys of the cluster that may take the freed slot
+	{
+		size_t slot_replace = next_slot(slot);
+		while (m_slot_list[slot_replace].node != NODE_INVALID)
+		{
+			size_t slot_opt = get_slot(m_slot_list[slot_replace].hash);
+			// The key at @slot_replace can move to @slot if @slot is cyclically in [slot_opt, slot_replace)
+			bool is_movable = (slot <= slot_replace) ? (slot_opt <= slot || slot_opt > slot_replace) : (slot_opt <= slot && slot_opt > slot_replace);
+			if (is_movable)
+			{
+				m_slot_list[slot] = m_slot_list[slot_replace];
+				slot = slot_replace;
+			}
+			slot_replace = next_slot(slot_replace);
+		}
+		m_slot_list[slot].node = NODE_INVALID;
+	}
+
+	void release_node(size_t slot)
+	{
+		Node & node = m_node_list[m_slot_list[slot].node];
+		node.link.remove_from_cycle();
+		node.link.insert_single_as_next_of(m_free_anchor);
+		remove_slot(slot);
+		m_size--;
+	}
+
+	void promote(Node & node)
+	{
+		node.link.remove_from_cycle();
+		node.link.insert_single_as_next_of(m_recent_anchor);
+	}
+
+public:
+
+	LRUCache(void) {clear();}
+	LRUCache(LRUCache const &) = delete;
+	LRUCache(LRUCache &&) = delete;
+	void operator=(LRUCache const &) = delete;
+	void operator=(LRUCache &&) = delete;
+
+	size_t get_size(void) const {return m_size;}
+	size_t get_capacity(void) const {return CAPACITY;}
+
+	// The entry becomes the most recently used
+	Value * find(Key const & key)
+	{
+		size_t slot = find_slot(key, get_hash(key));
+		if (slot == TABLE_CAPACITY) {return nullptr;}
+		Node & node = m_node_list[m_slot_list[slot].node];
+		promote(node);
+		return &node.value;
+	}
+
+	// The recency order is unchanged
+	Value * peek(Key const & key)
+	{
+		size_t slot = find_slot(key, get_hash(key));
+		return (slot == TABLE_CAPACITY) ? nullptr : &m_node_list[m_slot_list[slot].node].value;
+	}
+
+	// Replace current value if it exists; the entry becomes the most recently used
+	// The least recently used entry is evicted if the cache is full
+	void insert(Key const & key, Value const & value)
+	{
+		uint32_t hash = get_hash(key);
+		size_t slot = find_slot(key, hash);
+		if (slot != TABLE_CAPACITY)
+		{
+			Node & node = m_node_list[m_slot_list[slot].node];
+			node.value = value;
+			promote(node);
+			return;
+		}
+
+		if (m_size == CAPACITY)
+		{
+			Node & victim = *get_container<Node, LinkedCycle, &Node::link>(&m_recent_anchor.prev());
+			release_node(find_node_slot(victim));
+		}
+
+		LinkedCycle & link = m_free_anchor.next();
+		link.remove_from_cycle();
+		link.insert_single_as_next_of(m_recent_anchor);
+		Node & node = *get_container<Node, LinkedCycle, &Node::link>(&link);
+		node.hash = hash;
+		node.key = key;
+		node.value = value;
+
+		slot = get_slot(hash);
+		while (m_slot_list[slot].node != NODE_INVALID) {slot = next_slot(slot);}
+		m_slot_list[slot].node = get_node_index(link);
+		m_slot_list[slot].hash = hash;
+		m_size++;
+	}
+
+	// Remove the least recently used entry and return it; return false if the cache is empty
+	bool evict(Key & key, Value & value)
+	{
+		if (m_size == 0) {return false;}
+		Node & victim = *get_container<Node, LinkedCycle, &Node::link>(&m_recent_anchor.prev());
+		key = victim.key;
+		value = victim.value;
+		release_node(find_node_slot(victim));
+		return true;
+	}
+
+	// Remove the key if it exists
+	bool remove(Key const & key)
+	{
+		size_t slot = find_slot(key, get_hash(key));
+		if (slot == TABLE_CAPACITY) {return false;}
+		release_node(slot);
+		return true;
+	}
+
+	// Visit the entries from the most to the least recently used, as @visit(key, value)
+	template <typename Visit>
+	void for_each(Visit visit) const
+	{
+		for (LinkedCycle const * link = &m_recent_anchor.next(); link != &m_recent_anchor; link = &link->next())
+		{
+			Node const & node = *get_container<Node, LinkedCycle, &Node::link>(link);
+			visit(node.key, node.value);
+		}
+	}
+
+	void clear(void)
+	{
+		while (!m_recent_anchor.is_single()) {m_recent_anchor.next().remove_from_cycle();}
+		while (!m_free_anchor.is_single()) {m_free_anchor.next().remove_from_cycle();}
+		for (size_t i = 0; i < CAPACITY; i++)
+		{
+			m_node_list[i].link.insert_single_as_prev_of(m_free_anchor);
+		}
+		for (size_t i = 0; i < TABLE_CAPACITY; i++)
+		{
+			m_slot_list[i].node = NODE_INVALID;
+		}
+		m_size = 0;
+	}
+};
+
+
+
+}
@@ -0,0 +1,40 @@
+/*
+ * tx_member.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace TXLib
+{
+
+// Offset of the data member @MEMBER within @Type, where the member is only known as a pointer to member (offsetof() needs its name)
+// Used to recover an object from the address of an embedded link
+template <typename Type, typename Member, Member Type::* MEMBER>
+size_t member_offset(void)
+{
+	// From an aligned dummy address that is never dereferenced
+	size_t const base = alignof(Type) * 64;
+	return (size_t) &(reinterpret_cast<Type const *>(base)->*MEMBER) - base;
+}
+
+// Object whose data member @MEMBER is @member
+template <typename Type, typename Member, Member Type::* MEMBER>
+Type * get_container(Member * member)
+{
+	return reinterpret_cast<Type *>((size_t) member - member_offset<Type, Member, MEMBER>());
+}
+
+template <typename Type, typename Member, Member Type::* MEMBER>
+Type const * get_container(Member const * member)
+{
+	return reinterpret_cast<Type const *>((size_t) member - member_offset<Type, Member, MEMBER>());
+}
+
+
+
+}
@@ -82,7 +82,7 @@ public:
 	void register_free_block(MemBlock * block_ptr);
 	void unregister_free_block(MemBlock * block_ptr);
 
-	void * allocate(size_t size);
+	void * allocate(size_t size, bool is_fallible);
 	void free(void * content_ptr);
 };
 
@@ -148,7 +148,8 @@ void AllocatorHalfFitImpl::unregister_free_block(MemBlock * block_ptr)
 	}
 }
 
-void * AllocatorHalfFitImpl::allocate(size_t size)
+void * AllocatorHalfFitImpl::allocate(size_t size, bool is_fallible)
+// Return nullptr if @is_fallible and no free block is large enough
 {
 	// Adjust the allocation size to the nearest valid number
 	size += BLOCKUSED_INFO_SIZE;
@@ -157,12 +158,14 @@ void * AllocatorHalfFitImpl::allocate(size_t size)
 
 	// Find a suitable free block for the allocation
 	size_t index = get_order_from_size(size) + 1;
+	if (is_fallible && index >= free_block_list_size) {return nullptr;}
 	TX_ASSERT(index < free_block_list_size);
 	while (free_block_list[index] == nullptr)
 	{
 		index ++;
 		if (index >= free_block_list_size)
 		{
+			if (is_fallible) {return nullptr;}
 			TX_ASSERT(0); // Failing means out of memory; TODO: Replace by exception
 		}
 	}
@@ -324,7 +327,23 @@ void * AllocatorHalfFit::alloc(size_t content_size)
 	me->m_lock.acquire();
 
 	void * result;
-	result = me->allocate(content_size);
+	result = me->allocate(content_size, false);
+
+	me->m_lock.release();
+
+	return result;
+}
+
+void * AllocatorHalfFit::try_alloc(size_t content_size)
+{
+	TX_ASSERT(is_initialized());
+
+	AllocatorHalfFitImpl * me = (AllocatorHalfFitImpl *) this;
+
+	me->m_lock.acquire();
+
+	void * result;
+	result = me->allocate(content_size, true);
 
 	me->m_lock.release();
 
@@ -52,7 +52,7 @@ public:
 	AllocatorHalfFit(void) noexcept : address_start(0), address_end(0) {}
 	AllocatorHalfFit(AllocatorHalfFit const &) noexcept = delete;
 	AllocatorHalfFit(AllocatorHalfFit &&) noexcept = delete;
-	~AllocatorHalfFit(void) noexcept {uninitialize();}
+	~AllocatorHalfFit(void) noexcept {if (is_initialized()) {uninitialize();}}
 	void operator=(AllocatorHalfFit const &) noexcept = delete;
 	void operator=(AllocatorHalfFit &&) noexcept = delete;
 
@@ -61,6 +61,7 @@ public:
 	void uninitialize(void) noexcept;
 
 	void * alloc(size_t content_size) noexcept; // Reentrant
+	void * try_alloc(size_t content_size) noexcept; // Reentrant; return nullptr instead of failing when out of memory
 	void free(void * content_ptr) noexcept; // Reentrant
 	void clear(void) noexcept;
 
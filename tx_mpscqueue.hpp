@@ -0,0 +1,120 @@
+/*
+ * tx_mpscqueue.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include "tx_assert.h"
+#include "tx_cacheline.hpp"
+#include "tx_member.hpp"
+
+namespace TXLib
+{
+
+// Link embedded in the objects of an MPSCQueue
+class MPSCLink
+{
+	template <typename Type, MPSCLink Type::* LINK>
+	friend class MPSCQueue;
+
+private:
+	std::atomic<MPSCLink *>		m_next;
+
+public:
+	MPSCLink(void) noexcept : m_next(nullptr) {}
+	MPSCLink(MPSCLink const &) = delete;
+	MPSCLink(MPSCLink &&) = delete;
+	void operator=(MPSCLink const &) = delete;
+	void operator=(MPSCLink &&) = delete;
+};
+
+
+// Unbounded queue from any number of producer threads to a single consumer thread (Vyukov's intrusive MPSC queue)
+// Objects are linked through their MPSCLink member @LINK; the queue allocates nothing and never fills up
+// push() is wait-free: one atomic exchange and one store
+// pop() only loads, except when the queue runs out of objects, where a stub link is pushed back so that the last object can be taken
+// The queue is briefly inconsistent between the exchange and the store of a push; pop() then reports it empty until the store lands
+// An object can be pushed again once popped
+template <typename Type, MPSCLink Type::* LINK>
+class MPSCQueue
+{
+private:
+
+	alignas(TX_CACHE_LINE_SIZE) std::atomic<MPSCLink *>		m_head;		// Last link pushed; written by the producers
+	alignas(TX_CACHE_LINE_SIZE) MPSCLink *								m_tail;		// Next link to pop; only accessed by the consumer
+	MPSCLink																							m_stub;		// Keeps the list non-empty
+
+private:
+
+	static Type * get_object(MPSCLink * link) {return get_container<Type, MPSCLink, LINK>(link);}
+
+	void push_link(MPSCLink * link)
+	{
+		link->m_next.store(nullptr, std::memory_order_relaxed);
+		MPSCLink * prev = m_head.exchange(link, std::memory_order_acq_rel);
+		prev->m_next.store(link, std::memory_order_release);	// Publishes the link to the consumer
+	}
+
+public:
+
+	MPSCQueue(void) noexcept : m_head(&m_stub), m_tail(&m_stub) {}
+	MPSCQueue(MPSCQueue const &) = delete;
+	MPSCQueue(MPSCQueue &&) = delete;
+	void operator=(MPSCQueue const &) = delete;
+	void operator=(MPSCQueue &&) = delete;
+
+	// Any thread; @object must not be in the queue
+	void push(Type & object) {push_link(&(object.*LINK));}
+
+	// Consumer thread only
+	// Return nullptr if the queue is empty, or if the push of the next object has not completed
+	Type * pop(void)
+	{
+		MPSCLink * tail = m_tail;
+		MPSCLink * next = tail->m_next.load(std::memory_order_acquire);
+
+		// Skip the stub
+		if (tail == &m_stub)
+		{
+			if (next == nullptr) {return nullptr;}
+			m_tail = next;
+			tail = next;
+			next = next->m_next.load(std::memory_order_acquire);
+		}
+
+		if (next != nullptr)
+		{
+			m_tail = next;
+			return get_object(tail);
+		}
+
+		// @tail is the last link, unless a producer is between its exchange and its store
+		if (tail != m_head.load(std::memory_order_acquire)) {return nullptr;}
+
+		// Queue the stub behind @tail, so that @tail can be taken without leaving the list empty
+		push_link(&m_stub);
+		next = tail->m_next.load(std::memory_order_acquire);
+		if (next != nullptr)
+		{
+			m_tail = next;
+			return get_object(tail);
+		}
+		return nullptr;
+	}
+
+	// Consumer thread only; approximate while producers push
+	bool is_empty(void) const
+	{
+		MPSCLink const * tail = m_tail;
+		return tail == &m_stub && tail->m_next.load(std::memory_order_acquire) == nullptr;
+	}
+};
+
+
+
+}
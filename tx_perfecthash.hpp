@@ -0,0 +1,184 @@
+/*
+ * tx_perfecthash.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tx_assert.h"
+#include "tx_hashfunc.hpp"
+
+namespace TXLib
+{
+
+// Deliberately not constexpr: reached while building a PerfectHashTable in a constant expression, it fails the compilation
+inline void perfect_hash_keys_collide(void) {}
+
+
+// Immutable hash table over a key set known at compile time
+// The constructor builds a minimal perfect hash (PTHash-style, hash and displace): every key has its own slot among SIZE slots
+// Keys are split into buckets by their hash; buckets are placed largest first, each searching for a pilot value
+// that sends all of its keys to free slots. A lookup is one hash, one pilot load and one key comparison
+// Declared constexpr, the whole table is computed by the compiler and placed in read-only memory:
+//   constexpr uint64_t keyword_hash(std::string_view key) {return hash_bytes(key.data(), key.size());}
+//   static constexpr auto keyword_table = make_perfect_hash_table<std::string_view, int, keyword_hash>({{"if", 1}, {"else", 2}});
+// @hash_func must be usable in constant expressions and must not collide on the given keys
+// Otherwise, a constexpr table does not compile, and a table built at run time is invalid: is_valid() is false and find() always fails
+template <typename Key, typename Value, size_t SIZE, uint64_t hash_func(Key)>
+class PerfectHashTable
+{
+public:
+
+	struct Entry
+	{
+		Key			key;
+		Value		value;
+	};
+
+private:
+
+	static constexpr size_t const BUCKET_COUNT = (SIZE + 1) / 2;	// 2 keys per bucket on average
+	static constexpr uint32_t const PILOT_LIMIT = 1u << 20;				// The expected pilot is far lower; reaching the limit means colliding hashes
+
+	static_assert(SIZE > 0 && SIZE <= 0xFFFFFFFFu);
+
+private:
+
+	Key					m_key_list[SIZE];
+	Value				m_value_list[SIZE];
+	uint32_t		m_pilot_list[BUCKET_COUNT];
+	bool				m_is_valid;
+
+private:
+
+	static constexpr size_t get_bucket(uint64_t hash) {return reduce_range((uint32_t)(hash >> 32), BUCKET_COUNT);}
+	static constexpr size_t get_slot(uint64_t hash, uint32_t pilot) {return reduce_range((uint32_t) hash_combine(hash, pilot), SIZE);}
+
+public:
+
+	constexpr PerfectHashTable(Entry const (&entry_list)[SIZE]) : m_key_list{}, m_value_list{}, m_pilot_list{}, m_is_valid(false)
+	{
+		uint64_t hash_list[SIZE] = {};
+		size_t bucket_size_list[BUCKET_COUNT] = {};
+		for (size_t i = 0; i < SIZE; i++)
+		{
+			hash_list[i] = hash_func(entry_list[i].key);
+			bucket_size_list[get_bucket(hash_list[i])]++;
+		}
+
+		// Sort the keys by bucket, and the buckets by decreasing size (counting sorts)
+		size_t bucket_begin_list[BUCKET_COUNT + 1] = {};
+		for (size_t b = 0; b < BUCKET_COUNT; b++)
+		{
+			bucket_begin_list[b + 1] = bucket_begin_list[b] + bucket_size_list[b];
+		}
+		size_t entry_order[SIZE] = {};
+		size_t bucket_fill_list[BUCKET_COUNT] = {};
+		for (size_t i = 0; i < SIZE; i++)
+		{
+			size_t b = get_bucket(hash_list[i]);
+			entry_order[bucket_begin_list[b] + bucket_fill_list[b]] = i;
+			bucket_fill_list[b]++;
+		}
+		size_t size_begin_list[SIZE + 2] = {};
+		for (size_t b = 0; b < BUCKET_COUNT; b++)
+		{
+			size_begin_list[SIZE - bucket_size_list[b] + 1]++;
+		}
+		for (size_t s = 0; s <= SIZE; s++)
+		{
+			size_begin_list[s + 1] += size_begin_list[s];
+		}
+		size_t bucket_order[BUCKET_COUNT] = {};
+		for (size_t b = 0; b < BUCKET_COUNT; b++)
+		{
+			bucket_order[size_begin_list[SIZE - bucket_size_list[b]]++] = b;
+		}
+
+		// Place the buckets
+		bool is_taken_list[SIZE] = {};
+		for (size_t order = 0; order < BUCKET_COUNT; order++)
+		{
+			size_t b = bucket_order[order];
+			size_t begin = bucket_begin_list[b];
+			size_t end = bucket_begin_list[b + 1];
+			if (begin == end) {break;} // Remaining buckets are empty
+
+			// Keys with the same hash share their bucket, and no pilot separates them
+			for (size_t i = begin; i < end; i++)
+			{
+				for (size_t j = i + 1; j < end; j++)
+				{
+					if (hash_list[entry_order[i]] == hash_list[entry_order[j]])
+					{
+						perfect_hash_keys_collide();
+						return;
+					}
+				}
+			}
+
+			uint32_t pilot = 0;
+			while (1)
+			{
+				if (pilot == PILOT_LIMIT)
+				{
+					perfect_hash_keys_collide();
+					return;
+				}
+
+				// Try to take the slots of all keys; release them on conflict
+				size_t taken_count = 0;
+				for (; begin + taken_count < end; taken_count++)
+				{
+					size_t slot = get_slot(hash_list[entry_order[begin + taken_count]], pilot);
+					if (is_taken_list[slot]) {break;}
+					is_taken_list[slot] = true;
+				}
+				if (begin + taken_count == end) {break;}
+				for (size_t i = 0; i < taken_count; i++)
+				{
+					is_taken_list[get_slot(hash_list[entry_order[begin + i]], pilot)] = false;
+				}
+				pilot++;
+			}
+
+			m_pilot_list[b] = pilot;
+			for (size_t i = begin; i < end; i++)
+			{
+				Entry const & entry = entry_list[entry_order[i]];
+				size_t slot = get_slot(hash_list[entry_order[i]], pilot);
+				m_key_list[slot] = entry.key;
+				m_value_list[slot] = entry.value;
+			}
+		}
+		m_is_valid = true;
+	}
+
+	constexpr bool is_valid(void) const {return m_is_valid;}
+	constexpr size_t get_size(void) const {return SIZE;}
+
+	constexpr Value const * find(Key const & key) const
+	{
+		if (!m_is_valid) {return nullptr;}
+		uint64_t hash = hash_func(key);
+		size_t slot = get_slot(hash, m_pilot_list[get_bucket(hash)]);
+		return (m_key_list[slot] == key) ? &m_value_list[slot] : nullptr;
+	}
+
+};
+
+
+// Deduce SIZE from the number of entries
+template <typename Key, typename Value, uint64_t hash_func(Key), size_t SIZE>
+constexpr PerfectHashTable<Key, Value, SIZE, hash_func> make_perfect_hash_table(typename PerfectHashTable<Key, Value, SIZE, hash_func>::Entry const (&entry_list)[SIZE])
+{
+	return PerfectHashTable<Key, Value, SIZE, hash_func>(entry_list);
+}
+
+
+
+}
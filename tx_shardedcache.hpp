@@ -0,0 +1,202 @@
+/*
+ * tx_shardedcache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tx_assert.h"
+#include "tx_spinlock.hpp"
+#include "tx_cacheline.hpp"
+#include "tx_hash.hpp"
+#include "tx_hashfunc.hpp"
+
+namespace TXLib
+{
+
+// Cache shared by several threads, made of 2^SHARD_COUNT_LOG2 independent ForgetfulHash shards
+// The high half of the key hash selects the shard and the low half the slot within the shard, so that both are uncorrelated
+// Each shard has its own lock on its own cache line; threads only contend when they access the same shard
+// Values are copied in and out under the lock, hence no pointer into a shard escapes
+// Every shard keeps at most VALUE_CAPACITY values; the budget of each shard can be lowered at run time
+template <typename Key, typename Value, size_t SHARD_COUNT_LOG2, size_t KEY_CAPACITY, size_t VALUE_CAPACITY,
+		uint64_t hash_func(Key const &) = hash_value<Key>, template <size_t> class Eviction = EvictionNearest>
+class ShardedCache
+{
+private:
+
+	static constexpr size_t const SHARD_COUNT = 1u << SHARD_COUNT_LOG2;
+
+	static size_t get_slot(Key key) {return reduce_range((uint32_t) hash_func(key), KEY_CAPACITY);}
+	static size_t get_shard_index(Key const & key) {return reduce_range((uint32_t)(hash_func(key) >> 32), SHARD_COUNT);}
+
+	typedef ForgetfulHash<Key, Value, KEY_CAPACITY, VALUE_CAPACITY, get_slot, Eviction> Table;
+
+public:
+
+	typedef typename Table::Time Time;
+
+private:
+
+	struct alignas(TX_CACHE_LINE_SIZE) Shard
+	{
+		Spinlock		lock;
+		Table				table;
+	};
+
+private:
+
+	Shard				m_shard_list[SHARD_COUNT];
+
+public:
+
+	size_t get_shard_count(void) const {return SHARD_COUNT;}
+	size_t get_capacity(void) const {return SHARD_COUNT * VALUE_CAPACITY;}
+
+	// Copy the value to @value if the key exists
+	bool find(Key const & key, Value & value)
+	{
+		Shard & shard = m_shard_list[get_shard_index(key)];
+		shard.lock.acquire();
+		Value const * found = shard.table.find(key);
+		if (found != nullptr) {value = *found;}
+		shard.lock.release();
+		return found != nullptr;
+	}
+
+	// An expired entry is removed and reported as missing
+	bool find(Key const & key, Value & value, Time now)
+	{
+		Shard & shard = m_shard_list[get_shard_index(key)];
+		shard.lock.acquire();
+		Value const * found = shard.table.find(key, now);
+		if (found != nullptr) {value = *found;}
+		shard.lock.release();
+		return found != nullptr;
+	}
+
+	// Replace current value if it exists
+	// Another key of the same shard is replaced if the budget of the shard is reached
+	void insert(Key const & key, Value const & value)
+	{
+		Shard & shard = m_shard_list[get_shard_index(key)];
+		shard.lock.acquire();
+		shard.table.insert(key, value);
+		shard.lock.release();
+	}
+
+	// The entry expires at @expiry (see ForgetfulHash::insert())
+	void insert(Key const & key, Value const & value, Time expiry)
+	{
+		Shard & shard = m_shard_list[get_shard_index(key)];
+		shard.lock.acquire();
+		shard.table.insert(key, value, expiry);
+		shard.lock.release();
+	}
+
+	// Sweep up to @budget value slots of every shard, one shard lock at a time (see ForgetfulHash::sweep())
+	// Return the number of entries removed
+	size_t sweep(Time now, size_t budget)
+	{
+		size_t removed = 0;
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			m_shard_list[i].lock.acquire();
+			removed += m_shard_list[i].table.sweep(now, budget);
+			m_shard_list[i].lock.release();
+		}
+		return removed;
+	}
+
+	void clear(void)
+	{
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			m_shard_list[i].lock.acquire();
+			m_shard_list[i].table.clear();
+			m_shard_list[i].lock.release();
+		}
+	}
+
+	// Limit the number of values of shard @shard_index, or of every shard
+	void set_shard_budget(size_t shard_index, size_t budget)
+	{
+		TX_ASSERT(shard_index < SHARD_COUNT);
+		Shard & shard = m_shard_list[shard_index];
+		shard.lock.acquire();
+		shard.table.set_value_budget(budget);
+		shard.lock.release();
+	}
+
+	void set_shard_budget(size_t budget)
+	{
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			set_shard_budget(i, budget);
+		}
+	}
+
+	size_t get_shard_size(size_t shard_index)
+	{
+		TX_ASSERT(shard_index < SHARD_COUNT);
+		Shard & shard = m_shard_list[shard_index];
+		shard.lock.acquire();
+		size_t size = shard.table.get_size();
+		shard.lock.release();
+		return size;
+	}
+
+	// Statistics aggregated over the shards; each shard is sampled at a different time
+	size_t get_size(void)
+	{
+		size_t size = 0;
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			size += get_shard_size(i);
+		}
+		return size;
+	}
+
+	size_t get_hit_count(void)
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			m_shard_list[i].lock.acquire();
+			count += m_shard_list[i].table.get_hit_count();
+			m_shard_list[i].lock.release();
+		}
+		return count;
+	}
+
+	size_t get_miss_count(void)
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			m_shard_list[i].lock.acquire();
+			count += m_shard_list[i].table.get_miss_count();
+			m_shard_list[i].lock.release();
+		}
+		return count;
+	}
+
+	void reset_statistics(void)
+	{
+		for (size_t i = 0; i < SHARD_COUNT; i++)
+		{
+			m_shard_list[i].lock.acquire();
+			m_shard_list[i].table.reset_statistics();
+			m_shard_list[i].lock.release();
+		}
+	}
+
+};
+
+
+
+}
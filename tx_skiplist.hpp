@@ -0,0 +1,391 @@
+/*
+ * tx_skiplist.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+#include <utility>
+#include "tx_assert.h"
+#include "tx_spinlock.hpp"
+#include "tx_epoch.hpp"
+#include "tx_hashfunc.hpp"
+
+namespace TXLib
+{
+
+// Ordered map as a skip list for many readers and few writers
+// Readers take no lock: they traverse the towers with acquire loads inside an epoch of the list's EpochDomain
+// Writers serialize on a lock held only while they link and unlink: a new node is allocated and fully built before the lock is taken,
+// and unlinked nodes are retired after it is released. Nodes are linked bottom-up, and a removed node keeps its forward links,
+// so that a reader standing on it still reaches its successors
+// Writers are not lock-free by design: a CAS-based writer needs marked links and helping to unlink concurrently, which costs every
+// traversal, whereas this list targets rare writes; on a single core, writers cannot run in parallel anyway, and the lock (which masks
+// interrupts) is only held for the few stores of one linking
+// An entry is never modified once published: replacing a value links a new node in place of the old one, hence readers may keep references to entries
+// Removed nodes are retired to the epoch domain and recycled once no reader can see them
+// Towers of each height are carved from slabs allocated through @Alloc and recycled through a free list per height, under a lock of their own;
+// @Alloc is only called under that lock, hence need not be thread-safe
+// A tower of height h is kept with probability 4^-(h-1), and the slabs are sized accordingly
+template <typename Key, typename Value, size_t LEVEL_COUNT = 16>
+class ConcurrentSkipList
+{
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+private:
+
+	static_assert(LEVEL_COUNT > 0 && LEVEL_COUNT <= 32);
+
+	struct Node
+	{
+		EpochRetired									retired;	// Must be the first member
+		ConcurrentSkipList *					owner;
+		Key														key;
+		Value													value;
+		size_t												level_count;
+		std::atomic<Node *>						next_list[1];	// Followed by the links of the other levels
+
+		template <typename ... Args>
+		Node(ConcurrentSkipList * owner_init, size_t level_count_init, Key const & key_init, Args && ... args)
+			: owner(owner_init), key(key_init), value(std::forward<Args>(args) ...), level_count(level_count_init) {}
+	};
+
+	struct FreeNode
+	{
+		FreeNode *		next;
+	};
+
+	struct Slab
+	{
+		Slab *				next;
+	};
+
+	static constexpr size_t get_node_size(size_t level_count)
+	{
+		size_t size = sizeof(Node) + (level_count - 1) * sizeof(std::atomic<Node *>);
+		return ((size + alignof(Node) - 1) / alignof(Node)) * alignof(Node);
+	}
+
+	static constexpr size_t const SLAB_HEADER_SIZE = ((sizeof(Slab) + alignof(Node) - 1) / alignof(Node)) * alignof(Node);
+
+public:
+
+	// Readers hold a guard while they access entries through iterators
+	class ReadGuard
+	{
+	private:
+		EpochDomain &		m_epoch;
+		size_t					m_ticket;
+
+	public:
+		explicit ReadGuard(ConcurrentSkipList const & list) : m_epoch(list.m_epoch), m_ticket(list.m_epoch.enter()) {}
+		~ReadGuard(void) {m_epoch.exit(m_ticket);}
+		ReadGuard(ReadGuard const &) = delete;
+		void operator=(ReadGuard const &) = delete;
+	};
+
+	// Valid while a ReadGuard of the list is held; entries inserted concurrently may or may not be visited
+	class Iterator
+	{
+		friend ConcurrentSkipList<Key, Value, LEVEL_COUNT>;
+
+	private:
+		Node *				m_node;		// nullptr at the end
+
+	private:
+		explicit Iterator(Node * node) noexcept : m_node(node) {}
+
+	public:
+		Iterator(void) noexcept : m_node(nullptr) {}
+
+		Key const & get_key(void) const {return m_node->key;}
+		Value const & get_value(void) const {return m_node->value;}
+
+		Iterator & operator++(void)
+		{
+			m_node = m_node->next_list[0].load(std::memory_order_acquire);
+			return *this;
+		}
+
+		bool operator==(Iterator const & b) const {return m_node == b.m_node;}
+		bool operator!=(Iterator const & b) const {return m_node != b.m_node;}
+	};
+
+private:
+
+	std::atomic<Node *>		m_head_list[LEVEL_COUNT];		// First node of each level
+	std::atomic<size_t>		m_size;
+	mutable EpochDomain		m_epoch;
+
+	Spinlock							m_write_lock;				// Held by writers while they link and unlink nodes
+	std::atomic<uint32_t>	m_random;						// Weyl sequence, mixed into the height of new towers
+
+	Spinlock							m_pool_lock;				// Protects the members below
+	FreeNode *						m_free_list[LEVEL_COUNT];		// Free towers of each height
+	Slab *								m_slab_head;
+	size_t								m_slab_size_log2;
+
+	Alloc									m_alloc;
+	Free									m_free;
+
+private:
+
+	size_t pick_level_count(void)
+	{
+		// Each level is kept with probability 1/4
+		uint32_t random = hash_u32(m_random.fetch_add(0x9E3779B9u, std::memory_order_relaxed));
+		size_t level_count = 1;
+		while (level_count < LEVEL_COUNT && (random & 0b11u) == 0)
+		{
+			level_count++;
+			random >>= 2;
+		}
+		return level_count;
+	}
+
+	void * acquire_node(size_t level_count)
+	{
+		m_pool_lock.acquire();
+		FreeNode *& free_head = m_free_list[level_count - 1];
+		if (free_head == nullptr)
+		{
+			size_t shift = 2 * (level_count - 1);
+			size_t node_count = (shift < m_slab_size_log2) ? ((size_t) 1 << (m_slab_size_log2 - shift)) : 1;
+			size_t node_size = get_node_size(level_count);
+			Slab * slab = (Slab *) m_alloc(SLAB_HEADER_SIZE + node_count * node_size);
+			TX_ASSERT(slab != nullptr);
+			slab->next = m_slab_head;
+			m_slab_head = slab;
+
+			for (size_t i = 0; i < node_count; i++)
+			{
+				FreeNode * node = (FreeNode *)((size_t) slab + SLAB_HEADER_SIZE + i * node_size);
+				node->next = free_head;
+				free_head = node;
+			}
+		}
+		FreeNode * node = free_head;
+		free_head = node->next;
+		m_pool_lock.release();
+		return node;
+	}
+
+	// Called by the epoch domain, in the thread that collects
+	static void reclaim_node(EpochRetired * retired)
+	{
+		Node * node = (Node *) retired;
+		ConcurrentSkipList * owner = node->owner;
+		size_t level_count = node->level_count;
+		node->~Node();
+		FreeNode * free_node = (FreeNode *) node;
+		owner->m_pool_lock.acquire();
+		free_node->next = owner->m_free_list[level_count - 1];
+		owner->m_free_list[level_count - 1] = free_node;
+		owner->m_pool_lock.release();
+	}
+
+	// Last node before @key on every level, as the link array holding the pointer to the next node (m_head_list for none)
+	// Return the first node not smaller than @key
+	Node * find_predecessors(Key const & key, std::atomic<Node *> ** pred_list) const
+	{
+		std::atomic<Node *> * link_list = const_cast<std::atomic<Node *> *>(m_head_list);
+		Node * next = nullptr;
+		for (size_t level = LEVEL_COUNT; level-- > 0;)
+		{
+			next = link_list[level].load(std::memory_order_acquire);
+			while (next != nullptr && next->key < key)
+			{
+				link_list = next->next_list;
+				next = link_list[level].load(std::memory_order_acquire);
+			}
+			if (pred_list != nullptr) {pred_list[level] = link_list;}
+		}
+		return next;
+	}
+
+	Node * find_lower_bound(Key const & key) const {return find_predecessors(key, nullptr);}
+
+	static bool is_equal(Key const & a, Key const & b) {return !(a < b) && !(b < a);}
+
+public:
+
+	ConcurrentSkipList(void) noexcept : m_alloc(nullptr) {}
+	ConcurrentSkipList(Alloc alloc, Free free, size_t slab_size_log2) : m_alloc(nullptr) {initialize(alloc, free, slab_size_log2);}
+	~ConcurrentSkipList(void) noexcept {uninitialize();}
+	ConcurrentSkipList(ConcurrentSkipList const &) = delete;
+	ConcurrentSkipList(ConcurrentSkipList &&) = delete;
+	void operator=(ConcurrentSkipList const &) = delete;
+	void operator=(ConcurrentSkipList &&) = delete;
+
+	bool is_initialized(void) const {return m_alloc != nullptr;}
+
+	// Slabs of the lowest towers hold 2^(@slab_size_log2) nodes
+	void initialize(Alloc alloc, Free free, size_t slab_size_log2)
+	{
+		TX_ASSERT(!is_initialized());
+
+		for (size_t i = 0; i < LEVEL_COUNT; i++)
+		{
+			m_head_list[i].store(nullptr, std::memory_order_relaxed);
+			m_free_list[i] = nullptr;
+		}
+		m_size.store(0, std::memory_order_relaxed);
+		m_random.store(0, std::memory_order_relaxed);
+		m_slab_head = nullptr;
+		m_slab_size_log2 = slab_size_log2;
+		m_alloc = alloc;
+		m_free = free;
+	}
+
+	// There cannot be any reader or writer
+	void uninitialize(void)
+	{
+		if (!is_initialized()) {return;}
+
+		m_epoch.reclaim_all();
+		for (Node * node = m_head_list[0].load(std::memory_order_relaxed); node != nullptr;)
+		{
+			Node * next = node->next_list[0].load(std::memory_order_relaxed);
+			node->~Node();
+			node = next;
+		}
+		while (m_slab_head != nullptr)
+		{
+			Slab * next = m_slab_head->next;
+			m_free(m_slab_head);
+			m_slab_head = next;
+		}
+		m_alloc = nullptr;
+	}
+
+	// Approximate while writers are active
+	size_t get_size(void) const {return m_size.load(std::memory_order_relaxed);}
+
+	// Any thread; copy the value to @value if the key exists
+	bool find(Key const & key, Value & value) const
+	{
+		ReadGuard guard(*this);
+		Node * node = find_lower_bound(key);
+		if (node == nullptr || !is_equal(node->key, key)) {return false;}
+		value = node->value;
+		return true;
+	}
+
+	// The iterators require a ReadGuard
+	Iterator begin(void) const {return Iterator(m_head_list[0].load(std::memory_order_acquire));}
+	Iterator end(void) const {return Iterator();}
+
+	// First entry whose key is not smaller than @key
+	Iterator lower_bound(Key const & key) const {return Iterator(find_lower_bound(key));}
+
+	// Any thread; visit the entries with keys in [@low, @high) in order, as @visit(key, value)
+	template <typename Visit>
+	void for_each_in_range(Key const & low, Key const & high, Visit visit) const
+	{
+		ReadGuard guard(*this);
+		for (Node * node = find_lower_bound(low); node != nullptr && node->key < high; node = node->next_list[0].load(std::memory_order_acquire))
+		{
+			visit(node->key, node->value);
+		}
+	}
+
+	// Any thread; replace current value if it exists
+	// Return true if the key is new
+	template <typename ... Args>
+	bool insert(Key const & key, Args && ... args)
+	{
+		TX_ASSERT(is_initialized());
+
+		size_t level_count = pick_level_count();
+		Node * node = ::new(acquire_node(level_count)) Node(this, level_count, key, std::forward<Args>(args) ...);
+
+		m_write_lock.acquire();
+
+		std::atomic<Node *> * pred_list[LEVEL_COUNT];
+		Node * existing = find_predecessors(key, pred_list);
+		bool is_new = (existing == nullptr || !is_equal(existing->key, key));
+		size_t existing_level_count = is_new ? 0 : existing->level_count;
+
+		// The links of the new node skip the node it replaces
+		for (size_t level = 0; level < level_count; level++)
+		{
+			Node * next = pred_list[level][level].load(std::memory_order_relaxed);
+			if (level < existing_level_count) {next = existing->next_list[level].load(std::memory_order_relaxed);}
+			node->next_list[level].store(next, std::memory_order_relaxed);
+		}
+
+		// Link bottom-up; the node is complete before it becomes reachable
+		// Levels above the new node bypass the replaced node; until then, readers descend before it, as its key is not smaller
+		size_t top = (level_count > existing_level_count) ? level_count : existing_level_count;
+		for (size_t level = 0; level < top; level++)
+		{
+			Node * next = (level < level_count) ? node : existing->next_list[level].load(std::memory_order_relaxed);
+			pred_list[level][level].store(next, std::memory_order_release);
+		}
+		if (is_new) {m_size.fetch_add(1, std::memory_order_relaxed);}
+
+		m_write_lock.release();
+
+		if (!is_new) {m_epoch.retire(&existing->retired, reclaim_node);}
+		return is_new;
+	}
+
+	// Any thread; remove the key if it exists
+	bool remove(Key const & key)
+	{
+		m_write_lock.acquire();
+
+		std::atomic<Node *> * pred_list[LEVEL_COUNT];
+		Node * node = find_predecessors(key, pred_list);
+		bool is_found = (node != nullptr && is_equal(node->key, key));
+		if (is_found)
+		{
+			// Unlink top-down; the links of the node are kept for the readers standing on it
+			for (size_t level = node->level_count; level-- > 0;)
+			{
+				pred_list[level][level].store(node->next_list[level].load(std::memory_order_relaxed), std::memory_order_release);
+			}
+			m_size.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		m_write_lock.release();
+
+		if (is_found) {m_epoch.retire(&node->retired, reclaim_node);}
+		return is_found;
+	}
+
+	// Any thread; linear-time
+	void clear(void)
+	{
+		m_write_lock.acquire();
+
+		Node * node = m_head_list[0].load(std::memory_order_relaxed);
+		for (size_t level = 0; level < LEVEL_COUNT; level++)
+		{
+			m_head_list[level].store(nullptr, std::memory_order_release);
+		}
+		m_size.store(0, std::memory_order_relaxed);
+
+		m_write_lock.release();
+
+		// The detached nodes are no longer reachable by writers
+		while (node != nullptr)
+		{
+			Node * next = node->next_list[0].load(std::memory_order_relaxed);
+			m_epoch.retire(&node->retired, reclaim_node);
+			node = next;
+		}
+	}
+};
+
+
+
+}
@@ -0,0 +1,225 @@
+/*
+ * tx_string.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string_view>
+#include "tx_assert.h"
+
+namespace TXLib
+{
+
+// Character string with small string optimization
+// Up to INLINE_CAPACITY characters are stored in the object itself; longer strings are allocated through the @alloc and @free callbacks,
+// e.g. from a pool of AllocatorHalfFit
+// A string without callbacks is limited to INLINE_CAPACITY characters
+// The characters are always NUL-terminated
+// Appending several pieces at once sizes the buffer once for all of them
+class String
+{
+public:
+	typedef				void * (*Alloc)(size_t);
+	typedef				void (*Free)(void *);
+
+	static constexpr size_t const INLINE_CAPACITY = 23;
+
+private:
+
+	union
+	{
+		char				m_inline[INLINE_CAPACITY + 1];
+		char *			m_heap;
+	};
+	uint32_t			m_size;
+	uint32_t			m_capacity;		// INLINE_CAPACITY while the characters are inline; allocated strings are always longer
+
+	Alloc					m_alloc;
+	Free					m_free;
+
+private:
+
+	char * get_buffer(void) {return is_inline() ? m_inline : m_heap;}
+
+	void grow(size_t capacity)
+	// Reallocate with room for at least @capacity characters
+	{
+		TX_ASSERT(m_alloc != nullptr && m_free != nullptr); // Only inline strings can be used without allocator
+		TX_ASSERT(capacity < 0xFFFFFFFFu);
+
+		size_t capacity_new = 2 * (size_t) m_capacity;
+		if (capacity_new < capacity) {capacity_new = capacity;}
+		if (capacity_new >= 0xFFFFFFFFu) {capacity_new = 0xFFFFFFFEu;}
+
+		char * buffer = (char *) m_alloc(capacity_new + 1);
+		TX_ASSERT(buffer != nullptr);
+		memcpy(buffer, get_buffer(), m_size + 1);
+		if (!is_inline()) {m_free(m_heap);}
+
+		m_heap = buffer;
+		m_capacity = (uint32_t) capacity_new;
+	}
+
+	static size_t sum_size(void) {return 0;}
+
+	template <typename ... Views>
+	static size_t sum_size(std::string_view view, Views const & ... views) {return view.size() + sum_size(views ...);}
+
+	void append_unchecked(std::string_view view)
+	{
+		memcpy(get_buffer() + m_size, view.data(), view.size());
+		m_size += (uint32_t) view.size();
+	}
+
+public:
+
+	String(void) noexcept : m_size(0), m_capacity(INLINE_CAPACITY), m_alloc(nullptr), m_free(nullptr) {m_inline[0] = '\0';}
+	String(Alloc alloc, Free free) noexcept : m_size(0), m_capacity(INLINE_CAPACITY), m_alloc(alloc), m_free(free) {m_inline[0] = '\0';}
+	String(Alloc alloc, Free free, std::string_view view) : String(alloc, free) {append(view);}
+	String(String const &) = delete;
+	void operator=(String const &) = delete;
+
+	// The source keeps its callbacks and becomes empty
+	String(String && other) noexcept : String(other.m_alloc, other.m_free) {*this = std::move(other);}
+
+	void operator=(String && other) noexcept
+	{
+		TX_ASSERT(this != &other);
+		uninitialize();
+		m_alloc = other.m_alloc;
+		m_free = other.m_free;
+		m_size = other.m_size;
+		m_capacity = other.m_capacity;
+		if (other.is_inline())
+		{
+			memcpy(m_inline, other.m_inline, m_size + 1);
+		}
+		else
+		{
+			m_heap = other.m_heap;
+			other.m_capacity = INLINE_CAPACITY;
+		}
+		other.m_size = 0;
+		other.m_inline[0] = '\0';
+	}
+
+	~String(void) noexcept {uninitialize();}
+
+	// Release the allocated buffer; the string is then empty
+	void uninitialize(void)
+	{
+		if (!is_inline()) {m_free(m_heap);}
+		m_capacity = INLINE_CAPACITY;
+		m_size = 0;
+		m_inline[0] = '\0';
+	}
+
+	bool is_inline(void) const {return m_capacity == INLINE_CAPACITY;}
+	bool is_empty(void) const {return m_size == 0;}
+	size_t get_size(void) const {return m_size;}
+	size_t get_capacity(void) const {return m_capacity;}
+
+	char const * get_c_string(void) const {return is_inline() ? m_inline : m_heap;}
+	char * get_data(void) {return get_buffer();}
+	std::string_view get_view(void) const {return std::string_view(get_c_string(), m_size);}
+	operator std::string_view(void) const {return get_view();}
+
+	char & operator[](size_t index)
+	{
+		TX_ASSERT(index < m_size);
+		return get_buffer()[index];
+	}
+
+	char operator[](size_t index) const
+	{
+		TX_ASSERT(index < m_size);
+		return get_c_string()[index];
+	}
+
+	bool operator==(std::string_view view) const {return get_view() == view;}
+	bool operator!=(std::string_view view) const {return get_view() != view;}
+
+	// Ensure room for @capacity characters without further allocation
+	void reserve(size_t capacity)
+	{
+		if (capacity > m_capacity) {grow(capacity);}
+	}
+
+	// The buffer is kept
+	void clear(void)
+	{
+		m_size = 0;
+		get_buffer()[0] = '\0';
+	}
+
+	void assign(std::string_view view)
+	{
+		clear();
+		append(view);
+	}
+
+	// Append all the pieces with at most one allocation; the pieces must not point into this string
+	template <typename ... Views>
+	String & append(std::string_view view, Views const & ... views)
+	{
+		reserve(m_size + sum_size(view, views ...));
+		append_unchecked(view);
+		(append_unchecked(views), ...);
+		get_buffer()[m_size] = '\0';
+		return *this;
+	}
+
+	String & append(char c)
+	{
+		reserve(m_size + 1);
+		char * buffer = get_buffer();
+		buffer[m_size] = c;
+		m_size++;
+		buffer[m_size] = '\0';
+		return *this;
+	}
+
+	// Append formatted text as by printf
+	// The text is formatted in place in the spare capacity; only if it does not fit, the buffer grows once and the text is formatted again
+	String & append_format(char const * format, ...) __attribute__((format(printf, 2, 3)))
+	{
+		va_list args;
+		va_start(args, format);
+		va_list args_retry;
+		va_copy(args_retry, args);
+
+		size_t room = m_capacity - m_size;
+		int length = vsnprintf(get_buffer() + m_size, room + 1, format, args);
+		TX_ASSERT(length >= 0);
+		if ((size_t) length > room)
+		{
+			grow(m_size + (size_t) length);
+			vsnprintf(get_buffer() + m_size, (size_t) length + 1, format, args_retry);
+		}
+		m_size += (uint32_t) length;
+
+		va_end(args_retry);
+		va_end(args);
+		return *this;
+	}
+
+	// Shorten the string to @size characters
+	void truncate(size_t size)
+	{
+		TX_ASSERT(size <= m_size);
+		m_size = (uint32_t) size;
+		get_buffer()[m_size] = '\0';
+	}
+};
+
+
+
+}
@@ -0,0 +1,83 @@
+/*
+ * tx_stringkey.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: tian_
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string_view>
+#include "tx_hashfunc.hpp"
+
+namespace TXLib
+{
+
+// String key for HashTable and ForgetfulHash: a view of characters stored elsewhere, with its hash computed once
+// The characters must outlive the table, e.g. string literals, interned strings or an arena
+// Looking up a std::string_view converts it implicitly; the conversion hashes the characters but neither copies nor allocates:
+//   HashTable<StringKey, Value, 1024, STRING_KEY_INVALID, string_key_index<1024>, string_key_tag> table;
+//   Value * value = table.find(std::string_view(request_path, request_path_size));
+// The cached hash serves both the hashed position and the comparison, so that keys are hashed once,
+// and most mismatches are rejected without comparing the characters
+class StringKey
+{
+private:
+
+	static constexpr uint32_t const SIZE_INVALID = 0xFFFFFFFF;
+
+private:
+
+	char const *		m_data;
+	uint32_t				m_size;
+	uint32_t				m_hash;
+
+private:
+
+	static constexpr uint32_t fold_hash(uint64_t hash) {return (uint32_t)(hash ^ (hash >> 32));}
+
+public:
+
+	// The invalid key, distinct from the empty string
+	constexpr StringKey(void) : m_data(""), m_size(SIZE_INVALID), m_hash(0) {}
+
+	// @size must be below 2^32 - 1
+	constexpr StringKey(char const * data, size_t size) : m_data(data), m_size((uint32_t) size), m_hash(fold_hash(hash_bytes(data, size))) {}
+
+	constexpr StringKey(std::string_view view) : StringKey(view.data(), view.size()) {}
+
+	// Reuse the hash of a key with the same characters, e.g. when the characters are copied to their final storage
+	constexpr StringKey(char const * data, size_t size, uint32_t hash) : m_data(data), m_size((uint32_t) size), m_hash(hash) {}
+
+	bool is_valid(void) const {return m_size != SIZE_INVALID;}
+	char const * get_data(void) const {return m_data;}
+	size_t get_size(void) const {return m_size;}
+	uint32_t get_hash(void) const {return m_hash;}
+
+	std::string_view get_view(void) const {return std::string_view(m_data, m_size);}
+
+	bool operator==(StringKey const & other) const
+	{
+		if (m_hash != other.m_hash || m_size != other.m_size) {return false;}
+		if (m_data == other.m_data || !is_valid()) {return true;}
+		return memcmp(m_data, other.m_data, m_size) == 0;
+	}
+
+	bool operator!=(StringKey const & other) const {return !(*this == other);}
+};
+
+inline constexpr StringKey const STRING_KEY_INVALID;
+
+// hash_func of the tables keyed by StringKey; reduces the cached hash
+template <size_t CAPACITY>
+constexpr size_t string_key_index(StringKey key) {return reduce_range(key.get_hash(), (uint32_t) CAPACITY);}
+
+// tag_func of HashTable keyed by StringKey; the low bits of the cached hash hardly affect the hashed position
+inline uint8_t string_key_tag(StringKey const & key, size_t) {return (uint8_t)(key.get_hash() & 0x7Fu);}
+
+
+
+}